@@ -0,0 +1,195 @@
+#include "batch.hpp"
+
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <algorithm>
+
+#include <utki/debug.hpp>
+
+#include "dom.hpp"
+
+using namespace svgdom;
+
+namespace{
+// Range of document indices assigned to a worker, packed into single atomic
+// value: begin in lower 32 bits, end in upper 32 bits. The owner takes documents
+// from the beginning of the range, thieves take upper half of the range.
+class alignas(64) work_range{
+	std::atomic<uint64_t> range{0};
+
+	static uint64_t pack(uint32_t begin, uint32_t end)noexcept{
+		return uint64_t(begin) | (uint64_t(end) << 32);
+	}
+
+	static uint32_t begin_of(uint64_t r)noexcept{
+		return uint32_t(r);
+	}
+
+	static uint32_t end_of(uint64_t r)noexcept{
+		return uint32_t(r >> 32);
+	}
+
+public:
+	// only called by the owner when its range is empty
+	void set(uint32_t begin, uint32_t end)noexcept{
+		this->range.store(pack(begin, end));
+	}
+
+	bool pop_front(uint32_t& index)noexcept{
+		auto r = this->range.load();
+		while(true){
+			auto b = begin_of(r);
+			auto e = end_of(r);
+			if(b >= e){
+				return false;
+			}
+			if(this->range.compare_exchange_weak(r, pack(b + 1, e))){
+				index = b;
+				return true;
+			}
+		}
+	}
+
+	bool steal_half(uint32_t& begin, uint32_t& end)noexcept{
+		auto r = this->range.load();
+		while(true){
+			auto b = begin_of(r);
+			auto e = end_of(r);
+			if(b >= e){
+				return false;
+			}
+			auto new_end = e - (e - b + 1) / 2;
+			if(this->range.compare_exchange_weak(r, pack(b, new_end))){
+				begin = new_end;
+				end = e;
+				return true;
+			}
+		}
+	}
+};
+
+// reads whole file directly into the buffer, reusing its capacity left from previous files
+void read_file(const papki::file& f, std::vector<char>& buf){
+	papki::file::guard file_guard(f);
+
+	buf.clear();
+
+	while(true){
+		if(buf.size() == buf.capacity()){
+			buf.reserve(std::max(buf.capacity() * 2, size_t(4096)));
+		}
+		auto size = buf.size();
+		buf.resize(buf.capacity());
+
+		auto res = f.read(utki::make_span(reinterpret_cast<uint8_t*>(buf.data() + size), buf.size() - size));
+		ASSERT_ALWAYS(res <= buf.size() - size)
+		buf.resize(size + res);
+		if(res == 0){
+			break;
+		}
+	}
+}
+
+template <typename T_load_document>
+batch_load_result load_batch_internal(size_t num_documents, unsigned num_threads, const T_load_document& load_document){
+	if(num_documents > std::numeric_limits<uint32_t>::max()){
+		throw std::invalid_argument("load_batch(): too many documents");
+	}
+
+	if(num_threads == 0){
+		num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	num_threads = unsigned(std::min(size_t(num_threads), std::max(num_documents, size_t(1))));
+
+	batch_load_result ret;
+	ret.documents.resize(num_documents);
+	ret.errors.resize(num_documents);
+
+	for(unsigned i = 0; i != num_threads; ++i){
+		ret.arenas.push_back(std::make_unique<std::pmr::monotonic_buffer_resource>());
+	}
+
+	std::vector<work_range> ranges(num_threads);
+
+	// initially distribute documents evenly
+	for(unsigned i = 0; i != num_threads; ++i){
+		ranges[i].set(
+				uint32_t(num_documents * i / num_threads),
+				uint32_t(num_documents * (i + 1) / num_threads)
+			);
+	}
+
+	auto worker = [&](unsigned id){
+		auto& arena = *ret.arenas[id];
+		auto& own = ranges[id];
+
+		// buffer for reading documents, reused for all documents loaded by this worker
+		std::vector<char> buf;
+
+		while(true){
+			uint32_t index;
+			while(own.pop_front(index)){
+				try{
+					ret.documents[index] = load_document(index, arena, buf);
+				}catch(...){
+					ret.errors[index] = std::current_exception();
+				}
+			}
+
+			// own range is exhausted, try to steal from others
+			bool stolen = false;
+			for(unsigned i = 1; i != num_threads; ++i){
+				uint32_t begin, end;
+				if(ranges[(id + i) % num_threads].steal_half(begin, end)){
+					own.set(begin, end);
+					stolen = true;
+					break;
+				}
+			}
+			if(!stolen){
+				// all work is either done or taken by other workers
+				return;
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for(unsigned i = 1; i < num_threads; ++i){
+		threads.emplace_back(worker, i);
+	}
+
+	worker(0);
+
+	for(auto& t : threads){
+		t.join();
+	}
+
+	return ret;
+}
+}
+
+batch_load_result svgdom::load_batch(utki::span<const utki::span<const char>> buffers, unsigned num_threads){
+	return load_batch_internal(
+			buffers.size(),
+			num_threads,
+			[&buffers](size_t index, std::pmr::memory_resource& arena, std::vector<char>&){
+				return load(buffers[index], arena);
+			}
+		);
+}
+
+batch_load_result svgdom::load_batch(utki::span<const papki::file* const> files, unsigned num_threads){
+	return load_batch_internal(
+			files.size(),
+			num_threads,
+			[&files](size_t index, std::pmr::memory_resource& arena, std::vector<char>& buf){
+				ASSERT(files[index])
+				const auto& f = *files[index];
+
+				read_file(f, buf);
+
+				return load(utki::make_span(buf), arena);
+			}
+		);
+}
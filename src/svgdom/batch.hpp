@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <exception>
+
+#include <utki/span.hpp>
+
+#include <papki/file.hpp>
+
+#include "elements/structurals.hpp"
+
+namespace svgdom{
+
+/**
+ * @brief Result of loading a batch of SVG documents.
+ * Element objects of the loaded documents are allocated from the arenas owned by this object,
+ * so the documents must not outlive it. Data owned by the elements is allocated from the heap.
+ */
+struct batch_load_result{
+	/**
+	 * @brief Memory arenas holding the elements of loaded documents.
+	 * One arena per worker thread.
+	 * Declared before the documents, so that the arenas are destroyed after the documents.
+	 */
+	std::vector<std::unique_ptr<std::pmr::memory_resource>> arenas;
+
+	/**
+	 * @brief Loaded documents.
+	 * In the same order as the input. nullptr for the documents which failed to load.
+	 */
+	std::vector<std::unique_ptr<svg_element>> documents;
+
+	/**
+	 * @brief Loading errors.
+	 * In the same order as the input. For each document which failed to load
+	 * holds the thrown exception, e.g. malformed_svg_error, for other documents holds nullptr.
+	 */
+	std::vector<std::exception_ptr> errors;
+
+	batch_load_result() = default;
+
+	batch_load_result(const batch_load_result&) = delete;
+	batch_load_result& operator=(const batch_load_result&) = delete;
+
+	batch_load_result(batch_load_result&&) = default;
+
+	// member-wise move assignment would free the arenas before the documents
+	batch_load_result& operator=(batch_load_result&&) = delete;
+};
+
+/**
+ * @brief Load multiple SVG documents from memory buffers in parallel.
+ * The documents are distributed among worker threads, idle workers steal documents from busy ones.
+ * Each worker thread allocates element objects of the documents it loads from its own memory arena.
+ * @param buffers - input buffers to load SVG documents from.
+ * @param num_threads - number of worker threads to use, 0 means number of hardware threads.
+ * @return loaded documents and loading errors.
+ */
+batch_load_result load_batch(utki::span<const utki::span<const char>> buffers, unsigned num_threads = 0);
+
+/**
+ * @brief Load multiple SVG documents from files in parallel.
+ * Same as load_batch() for memory buffers, but files are also read by the worker threads.
+ * Each file object is only accessed by one worker thread.
+ * @param files - file interfaces to load SVG documents from.
+ * @param num_threads - number of worker threads to use, 0 means number of hardware threads.
+ * @return loaded documents and loading errors.
+ */
+batch_load_result load_batch(utki::span<const papki::file* const> files, unsigned num_threads = 0);
+
+}
@@ -1,7 +1,41 @@
 #include "cloner.hpp"
 
+#include "visit_tree.hpp"
+
 using namespace svgdom;
 
+namespace{
+template <class T> std::unique_ptr<T> copy_element(const T& e, bool copy_on_write){
+	// copies of path data and style maps share the data with the original
+	auto ret = std::make_unique<T>(e);
+	if(!copy_on_write){
+		if constexpr (std::is_base_of<styleable, T>::value){
+			ret->styles.unshare();
+			ret->presentation_attributes.unshare();
+		}
+		if constexpr (std::is_same<path_element, T>::value){
+			ret->path.unshare();
+		}
+	}
+	return ret;
+}
+}
+
+void cloner::clone(const element& e){
+	visit_element(e, [this](const auto& e){
+		typedef std::remove_const_t<std::remove_reference_t<decltype(e)>> type;
+
+		// custom elements cannot be copied
+		if constexpr (!std::is_same<element, type>::value){
+			auto clone = copy_element(e, this->copy_on_write);
+			if constexpr (std::is_base_of<container, type>::value){
+				this->clone_children(e, *clone);
+			}
+			this->cur_parent->children.push_back(std::move(clone));
+		}
+	});
+}
+
 void cloner::clone_children(const container& e, container& clone){
 	auto oldParent = this->cur_parent;
 	this->cur_parent = &clone;
@@ -9,105 +43,10 @@ void cloner::clone_children(const container& e, container& clone){
 	this->cur_parent = oldParent;
 }
 
-void cloner::visit(const g_element& e) {
-	auto clone = std::make_unique<g_element>(e);
-	this->clone_children(e, *clone);
-	this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const symbol_element& e) {
-	auto clone = std::make_unique<symbol_element>(e);
-	this->clone_children(e, *clone); 
-	this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const svg_element& e) {
-	auto clone = std::make_unique<svg_element>(e);
-	this->clone_children(e, *clone); 
-	this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const radial_gradient_element& e) {
-	auto clone = std::make_unique<radial_gradient_element>(e);
-	this->clone_children(e, *clone); 
-	this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const linear_gradient_element& e) {
-	auto clone = std::make_unique<linear_gradient_element>(e);
-	this->clone_children(e, *clone); 
-	this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const defs_element& e) {
-	auto clone = std::make_unique<defs_element>(e);
-	this->clone_children(e, *clone); 
-	this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const filter_element& e) {
-	auto clone = std::make_unique<filter_element>(e);
-	this->clone_children(e, *clone); 
-	this->cur_parent->children.push_back(std::move(clone));
-}
-
-
-void cloner::visit(const polyline_element& e) {
-	auto clone = std::make_unique<polyline_element>(e);
-	this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const circle_element& e) {
-	auto clone = std::make_unique<circle_element>(e);
-    this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const use_element& e) {
-	auto clone = std::make_unique<use_element>(e);
-    this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const gradient::stop_element& e) {
-	auto clone = std::make_unique<gradient::stop_element>(e);
-    this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const path_element& e) {
-	auto clone = std::make_unique<path_element>(e);
-    this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const rect_element& e) {
-	auto clone = std::make_unique<rect_element>(e);
-    this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const line_element& e) {
-	auto clone = std::make_unique<line_element>(e);
-    this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const ellipse_element& e) {
-	auto clone = std::make_unique<ellipse_element>(e);
-    this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const polygon_element& e) {
-	auto clone = std::make_unique<polygon_element>(e);
-    this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const fe_gaussian_blur_element& e) {
-	auto clone = std::make_unique<fe_gaussian_blur_element>(e);
-    this->cur_parent->children.push_back(std::move(clone));
-}
-
-void cloner::visit(const image_element& e) {
-	auto clone = std::make_unique<image_element>(e);
-    this->cur_parent->children.push_back(std::move(clone));
+void cloner::default_visit(const element& e){
+	this->clone(e);
 }
 
-void cloner::visit(const style_element& e) {
-    auto clone = std::make_unique<style_element>(e);
-    this->cur_parent->children.push_back(std::move(clone));
+void cloner::default_visit(const element& e, const container& c){
+	this->clone(e);
 }
@@ -6,14 +6,35 @@ namespace svgdom{
 /**
  * @brief clone visitor.
  * A visitor which allows cloning of Elements (and their children).
+ * Each element, including descendants, is passed the cloner to accept, so subclasses can
+ * override visit() methods for particular element types. The default implementations copy
+ * the element by switching on its type tag, see visit_element(). The cloner skips custom elements.
  */
 class cloner : virtual public svgdom::const_visitor{
 	svgdom::container root;
 	svgdom::container* cur_parent = &root;
 
-	void clone_children(const svgdom::container& e, svgdom::container& clone); 
+	bool copy_on_write;
+
+	void clone(const svgdom::element& e);
+
+	void clone_children(const svgdom::container& e, svgdom::container& clone);
 	
 public:
+	/**
+	 * @brief Create cloner.
+	 * In copy-on-write mode path data and style maps of the clone share the data with the original element,
+	 * the data is copied only when the clone or the original is modified, see path_element::packed_path
+	 * and style_map. This makes cloning of a big template document and then changing a few attributes
+	 * much cheaper. Otherwise, the clone gets its own copy of the data right away.
+	 * The shared data is reference counted, cloning does not modify the original element,
+	 * so several threads can clone the same document simultaneously.
+	 * @param copy_on_write - whether to make copy-on-write clones.
+	 */
+	cloner(bool copy_on_write = false) :
+			copy_on_write(copy_on_write)
+	{}
+
 	/**
 	* @brief Clone root element as T.
 	* @return std::unique<T> where T is element type of root.
@@ -30,25 +51,8 @@ public:
 		return ret;
 	}
 
-	void visit(const svgdom::path_element& e) override;
-	void visit(const svgdom::rect_element& e) override;
-	void visit(const svgdom::circle_element& e) override;
-	void visit(const svgdom::ellipse_element& e) override;
-	void visit(const svgdom::line_element& e) override;
-	void visit(const svgdom::polyline_element& e) override;
-	void visit(const svgdom::polygon_element& e) override;
-	void visit(const svgdom::g_element& e) override;
-	void visit(const svgdom::svg_element& e) override;
-	void visit(const svgdom::symbol_element& e) override;
-	void visit(const svgdom::use_element& e) override;
-	void visit(const svgdom::defs_element& e) override;
-	void visit(const svgdom::gradient::stop_element& e) override;
-	void visit(const svgdom::linear_gradient_element& e) override;
-	void visit(const svgdom::radial_gradient_element& e) override;
-	void visit(const svgdom::filter_element& e) override;
-	void visit(const svgdom::fe_gaussian_blur_element& e) override;
-	void visit(const svgdom::image_element& e) override;
-	void visit(const svgdom::style_element& e) override;
+	void default_visit(const svgdom::element& e) override;
+	void default_visit(const svgdom::element& e, const svgdom::container& c) override;
 };
 
 }
@@ -3,48 +3,47 @@
 #include "util.hxx"
 
 #include "parser.hxx"
+#include "mapped_file.hxx"
 
 using namespace svgdom;
 
+namespace{
+void feed(svgdom::parser& parser, const papki::file& f){
+	papki::file::guard file_guard(f);
+
+	std::array<uint8_t, 4096> buf; // 4k
+
+	while(true){
+		auto res = f.read(utki::make_span(buf));
+		ASSERT_ALWAYS(res <= buf.size())
+		if(res == 0){
+			break;
+		}
+		parser.feed(utki::make_span(buf.data(), res));
+	}
+	parser.end();
+}
+}
+
 std::unique_ptr<svg_element> svgdom::load(const papki::file& f){
 	svgdom::parser parser;
 	
-	{
-		papki::file::guard file_guard(f);
-
-		std::array<uint8_t, 4096> buf; // 4k
-
-		while(true){
-			auto res = f.read(utki::make_span(buf));
-			ASSERT_ALWAYS(res <= buf.size())
-			if(res == 0){
-				break;
-			}
-			parser.feed(utki::make_span(buf.data(), res));
-		}
-		parser.end();
-	}
+	feed(parser, f);
 	
 	return parser.get_dom();
 }
 
 std::unique_ptr<svg_element> svgdom::load(std::istream& s){
 	svgdom::parser parser;
-	
-	while(!s.eof()){
-		std::vector<char> buf;
-		for(unsigned i = 0; i != 4096; ++i){
-			char c;
-			s >> c;
-			if(s.eof()){
-				break;
-			}
-			buf.push_back(c);
-		}
-		parser.feed(utki::make_span(buf));
+
+	// read in blocks, unformatted, so that whitespace is preserved
+	std::vector<char> buf(0x10000); // 64k
+
+	while(s.read(buf.data(), buf.size()) || s.gcount() != 0){
+		parser.feed(utki::make_span(buf.data(), size_t(s.gcount())));
 	}
 	parser.end();
-	
+
 	return parser.get_dom();
 }
 
@@ -63,4 +62,54 @@ std::unique_ptr<svg_element> svgdom::load(utki::span<const char> buf){
 	parser.end();
 
 	return parser.get_dom();
-}
\ No newline at end of file
+}
+
+std::unique_ptr<svg_element> svgdom::load_mapped(const std::string& path){
+	mapped_file file(path);
+
+	return load(file.span());
+}
+
+std::unique_ptr<svg_element> svgdom::load(utki::span<const char> buf, std::pmr::memory_resource& resource){
+	svgdom::parser parser;
+	parser.element_resource = &resource;
+
+	parser.feed(buf);
+	parser.end();
+
+	return parser.get_dom();
+}
+
+std::unique_ptr<svg_element> svgdom::load_lazy(const papki::file& f){
+	svgdom::parser parser;
+	parser.lazy = true;
+
+	feed(parser, f);
+
+	return parser.get_dom();
+}
+
+std::unique_ptr<svg_element> svgdom::load_lazy(utki::span<const char> buf){
+	svgdom::parser parser;
+	parser.lazy = true;
+
+	parser.feed(buf);
+	parser.end();
+
+	return parser.get_dom();
+}
+
+void svgdom::load_streaming(const papki::file& f, const streaming_handler& handler){
+	svgdom::parser parser;
+	parser.streaming_handler = handler;
+
+	feed(parser, f);
+}
+
+void svgdom::load_streaming(utki::span<const char> buf, const streaming_handler& handler){
+	svgdom::parser parser;
+	parser.streaming_handler = handler;
+
+	parser.feed(buf);
+	parser.end();
+}
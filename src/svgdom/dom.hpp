@@ -1,5 +1,8 @@
 #pragma once
 
+#include <memory_resource>
+#include <functional>
+
 #include <utki/config.hpp>
 
 #include <papki/file.hpp>
@@ -47,4 +50,83 @@ std::unique_ptr<svg_element> load(utki::span<const char> buf);
  */
 std::unique_ptr<svg_element> load(utki::span<const uint8_t> buf);
 
+/**
+ * @brief Load SVG document from local file using memory mapping.
+ * The whole file is mapped to memory and parsed in one pass, without copying
+ * the file contents to intermediate buffers. Only works for files of the
+ * local file system, for other files use load(const papki::file&).
+ * @param path - path to the file to load SVG from.
+ * @return unique pointer to the root of SVG document tree.
+ * @throw std::system_error - in case the file could not be opened or mapped.
+ */
+std::unique_ptr<svg_element> load_mapped(const std::string& path);
+
+/**
+ * @brief Load SVG document from memory buffer, allocating element objects from memory resource.
+ * Only the element objects themselves are allocated from the given memory resource. Data owned
+ * by the elements, like strings, lists of children, styles or path coordinates, is allocated from
+ * the heap. Deleting the document tree runs destructors of all the elements as usual, but memory
+ * of the element objects is not returned to the memory resource, it is reclaimed when the memory
+ * resource releases all its memory, so std::pmr::monotonic_buffer_resource is the intended memory resource.
+ * The memory resource must outlive the returned document tree. Elements which are added
+ * to the tree later, after loading, are allocated from the heap as usual.
+ * @param buf - input buffer to load SVG from.
+ * @param resource - memory resource to allocate element objects from.
+ * @return unique pointer to the root of SVG document tree.
+ */
+std::unique_ptr<svg_element> load(utki::span<const char> buf, std::pmr::memory_resource& resource);
+
+/**
+ * @brief Load SVG document with lazy parsing.
+ * Path data ('d' attribute), transformations ('transform' and 'gradientTransform' attributes)
+ * and 'style' attribute are not parsed during loading. Instead, their raw text is stored in
+ * the elements and is parsed on first access to path_element::path, transformable::transformations
+ * or styleable::styles respectively. This makes loading faster when only a part of the document
+ * is going to be accessed, e.g. element ids or view box.
+ * Parsing on first access is thread safe, i.e. different threads can access the same
+ * not yet parsed element for reading simultaneously.
+ * @param f - file interface to load SVG from.
+ * @return unique pointer to the root of SVG document tree.
+ */
+std::unique_ptr<svg_element> load_lazy(const papki::file& f);
+
+/**
+ * @brief Load SVG document with lazy parsing.
+ * See load_lazy(const papki::file&) for details.
+ * @param buf - input buffer to load SVG from.
+ * @return unique pointer to the root of SVG document tree.
+ */
+std::unique_ptr<svg_element> load_lazy(utki::span<const char> buf);
+
+/**
+ * @brief Handler of elements for streaming SVG document loading.
+ * @param e - element which has just been completely parsed. The element is deleted
+ *            right after the handler returns, its children have already been deleted
+ *            when they were passed to the handler.
+ * @param ancestors - ancestors of the element, from the root 'svg' element to the parent.
+ *                    The ancestors have all attributes parsed, but have no children.
+ */
+typedef std::function<void(element& e, utki::span<element* const> ancestors)> streaming_handler;
+
+/**
+ * @brief Load SVG document in streaming mode.
+ * Elements are passed to the handler one by one as soon as each element's end tag
+ * is parsed, and then deleted, so the whole document tree is never built.
+ * Thus, the memory used is bounded by the depth of the document tree, not by its size.
+ * Elements which would not be added to the document tree by load(), e.g. descendants of
+ * unknown elements, are not passed to the handler.
+ * The handler can use visitor pattern on the element to find out its type.
+ * @param f - file interface to load SVG from.
+ * @param handler - handler of the elements.
+ */
+void load_streaming(const papki::file& f, const streaming_handler& handler);
+
+/**
+ * @brief Load SVG document in streaming mode.
+ * See load_streaming(const papki::file&, const streaming_handler&) for details.
+ * @param buf - input buffer to load SVG from.
+ * @param handler - handler of the elements.
+ */
+void load_streaming(utki::span<const char> buf, const streaming_handler& handler);
+
 }
@@ -2,10 +2,12 @@
 
 #include <sstream>
 
+#include "../util.hxx"
+
 using namespace svgdom;
 
 namespace{
-aspect_ratioed::aspect_ratio_preservation stringToPreserveAspectRatio(const std::string& str){
+aspect_ratioed::aspect_ratio_preservation stringToPreserveAspectRatio(std::string_view str){
 	if(str == "none"){
 		return aspect_ratioed::aspect_ratio_preservation::none;
 	}else if(str == "xMinYMin"){
@@ -31,23 +33,21 @@ aspect_ratioed::aspect_ratio_preservation stringToPreserveAspectRatio(const std:
 }
 }
 
-void aspect_ratioed::aspect_ratio_preservation_value::parse(const std::string& str){
-	std::istringstream s(str);
-	
-	s >> std::skipws;
-	
-	std::string tmp;
+void aspect_ratioed::aspect_ratio_preservation_value::parse(std::string_view str){
+	string_parser s(str);
 	
-	s >> tmp;
+	s.skip_whitespaces();
+	auto tmp = s.read_word();
 	
-	if(s.fail()){
+	if(tmp.empty()){
 		return;
 	}
 	
 	if(tmp == "defer"){
 		this->defer = true;
-		s >> tmp;
-		if(s.fail()){
+		s.skip_whitespaces();
+		tmp = s.read_word();
+		if(tmp.empty()){
 			return;
 		}
 	}else{
@@ -56,8 +56,9 @@ void aspect_ratioed::aspect_ratio_preservation_value::parse(const std::string& s
 	
 	this->preserve = stringToPreserveAspectRatio(tmp);
 	
-	s >> tmp;
-	if(s.fail()){
+	s.skip_whitespaces();
+	tmp = s.read_word();
+	if(tmp.empty()){
 		return;
 	}
 	
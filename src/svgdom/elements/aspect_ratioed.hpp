@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace svgdom{
 struct aspect_ratioed{
@@ -23,7 +24,7 @@ struct aspect_ratioed{
 		bool slice = false;
 
 		std::string to_string()const;
-		void parse(const std::string& str);
+		void parse(std::string_view str);
 	} preserve_aspect_ratio;
 };
 
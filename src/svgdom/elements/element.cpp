@@ -10,10 +10,10 @@
 using namespace svgdom;
 
 std::string element::to_string()const{
-	std::stringstream s;
+	std::string s;
 	
 	stream_writer visitor(s);
 	this->accept(visitor);
 	
-	return s.str();
+	return s;
 }
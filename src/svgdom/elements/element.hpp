@@ -2,6 +2,8 @@
 
 #include <ostream>
 
+#include "element_type.hpp"
+
 namespace svgdom{
 
 class visitor;
@@ -11,10 +13,28 @@ class const_visitor;
  * @brief Base class for all SVG document elements.
  */
 struct element{
+protected:
+	/**
+	 * @brief Type tag of the element.
+	 * Set by constructors of the element classes known to the visitor.
+	 */
+	element_type type_tag = element_type::unknown;
+
+public:
 	std::string id;
 	
 	std::string to_string()const;
 
+	/**
+	 * @brief Get element type.
+	 * Unlike visiting the element, getting the type does not involve virtual calls,
+	 * see also visit_tree().
+	 * @return type of the element, element_type::unknown for custom elements.
+	 */
+	element_type get_type()const noexcept{
+		return this->type_tag;
+	}
+
 	/**
 	 * @brief Accept method for visitor pattern.
 	 * @param v - visitor to accept.
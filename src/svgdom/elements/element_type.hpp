@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+namespace svgdom{
+
+/**
+ * @brief Type of SVG element.
+ * One value for each element class known to the visitor.
+ * The values are stored in binary snapshots, so new values are only to be added before ENUM_SIZE.
+ */
+enum class element_type : uint8_t{
+	unknown,
+	path,
+	rect,
+	circle,
+	ellipse,
+	line,
+	polyline,
+	polygon,
+	g,
+	svg,
+	symbol,
+	use,
+	defs,
+	stop,
+	linear_gradient,
+	radial_gradient,
+	filter,
+	fe_gaussian_blur,
+	fe_color_matrix,
+	fe_blend,
+	fe_composite,
+	image,
+	mask,
+	text,
+	style,
+
+	ENUM_SIZE
+};
+
+}
@@ -24,6 +24,10 @@ struct filter_element :
 
 	// NOTE: filterRes attribute is dropped, it seems deprecated.
 	
+	filter_element(){
+		this->type_tag = element_type::filter;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -84,6 +88,10 @@ struct fe_gaussian_blur_element :
 
 	r4::vector2<real> get_std_deviation()const noexcept;
 
+	fe_gaussian_blur_element(){
+		this->type_tag = element_type::fe_gaussian_blur;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -107,8 +115,12 @@ struct fe_color_matrix_element :
 
 	type type_ = type::matrix;
 
-	std::array<real, 20> values;
+	std::array<real, 20> values{};
 	
+	fe_color_matrix_element(){
+		this->type_tag = element_type::fe_color_matrix;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -132,6 +144,10 @@ struct fe_blend_element :
 		lighten
 	} mode_ = mode::normal;
 
+	fe_blend_element(){
+		this->type_tag = element_type::fe_blend;
+	}
+
 	void accept(visitor& v) override;
 	void accept(const_visitor& v) const override;
 
@@ -156,8 +172,12 @@ struct fe_composite_element :
 		arithmetic
 	} operator__ = operator_::over;
 
-	real k1, k2, k3, k4;
+	real k1 = 0, k2 = 0, k3 = 0, k4 = 0;
 	
+	fe_composite_element(){
+		this->type_tag = element_type::fe_composite;
+	}
+
 	void accept(visitor& v) override;
 	void accept(const_visitor& v) const override;
 
@@ -34,8 +34,12 @@ struct gradient :
 			public element,
 			public styleable
 	{
-		real offset;
+		real offset = 0;
 		
+		stop_element(){
+			this->type_tag = element_type::stop;
+		}
+
 		void accept(visitor& v)override;
 		void accept(const_visitor& v) const override;
 
@@ -63,6 +67,10 @@ struct linear_gradient_element : public gradient{
 	length x2 = length(100, length_unit::unknown);
 	length y2 = length(0, length_unit::unknown);
 	
+	linear_gradient_element(){
+		this->type_tag = element_type::linear_gradient;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -80,6 +88,10 @@ struct radial_gradient_element : public gradient{
 	length fx = length(50, length_unit::unknown);
 	length fy = length(50, length_unit::unknown);
 	
+	radial_gradient_element(){
+		this->type_tag = element_type::radial_gradient;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
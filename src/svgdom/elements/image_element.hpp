@@ -16,6 +16,10 @@ struct image_element :
 		public referencing,
 		public aspect_ratioed
 {
+	image_element(){
+		this->type_tag = element_type::image;
+	}
+
 	void accept(visitor& v) override;
 	void accept(const_visitor& v) const override;
 
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <mutex>
+
+namespace svgdom{
+
+/**
+ * @brief Raw attribute text kept for parsing on first access.
+ * Used by containers of parsed attribute values to support lazy loading, see load_lazy().
+ * The text is parsed at most once, even if first access happens from several threads simultaneously.
+ * Not copyable, the owning container copies its parsed values instead.
+ */
+class lazy_attribute{
+	struct source{
+		std::string text;
+		std::once_flag parsed;
+	};
+
+	std::unique_ptr<source> src;
+
+public:
+	lazy_attribute() = default;
+
+	lazy_attribute(const lazy_attribute&) = delete;
+	lazy_attribute& operator=(const lazy_attribute&) = delete;
+
+	lazy_attribute(lazy_attribute&&) = default;
+	lazy_attribute& operator=(lazy_attribute&&) = default;
+
+	/**
+	 * @brief Set raw attribute text.
+	 * @param text - attribute text to parse on first access.
+	 */
+	void set(std::string text){
+		this->src = std::make_unique<source>();
+		this->src->text = std::move(text);
+	}
+
+	/**
+	 * @brief Forget raw attribute text, if any.
+	 */
+	void reset()noexcept{
+		this->src.reset();
+	}
+
+	/**
+	 * @brief Parse raw attribute text if it was not parsed yet.
+	 * Does nothing if there is no raw attribute text. Thread safe.
+	 * @param parse - function to call with the raw attribute text. If it throws,
+	 *                the text remains unparsed and the exception is propagated.
+	 */
+	template <typename T_parse> void parse_once(const T_parse& parse)const{
+		if(!this->src){
+			return;
+		}
+		std::call_once(this->src->parsed, [this, &parse](){
+			parse(std::string_view(this->src->text));
+			// text is not needed anymore
+			this->src->text = std::string();
+		});
+	}
+};
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace svgdom{
+
+/**
+ * @brief Reference counter of a copy-on-write memory block.
+ * Used by containers of parsed attribute values which share their memory block between copies,
+ * see path_element::packed_path and style_map. The block is created with one reference.
+ * Before the block is modified in place, its owner checks that the block is not shared.
+ * The check is acquire-ordered, so that if other copies were dropped by other threads, all
+ * their accesses to the block happen before the modification.
+ */
+class ref_counter{
+	std::atomic<uint32_t> num_refs{1};
+
+public:
+	ref_counter() = default;
+
+	ref_counter(const ref_counter&) = delete;
+	ref_counter& operator=(const ref_counter&) = delete;
+
+	/**
+	 * @brief Add reference.
+	 * Called when a copy of the block owner is made, the block is not modified by that.
+	 */
+	void add_ref()noexcept{
+		this->num_refs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Remove reference.
+	 * @return true if it was the last reference and the block has to be freed.
+	 */
+	bool release()noexcept{
+		return this->num_refs.fetch_sub(1, std::memory_order_acq_rel) == 1;
+	}
+
+	/**
+	 * @brief Check if the block is shared.
+	 * @return true if the block has other references besides the caller's one.
+	 */
+	bool is_shared()const noexcept{
+		return this->num_refs.load(std::memory_order_acquire) != 1;
+	}
+};
+
+}
@@ -2,6 +2,10 @@
 
 #include <sstream>
 #include <cctype>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <new>
 
 #include <utki/debug.hpp>
 
@@ -75,42 +79,55 @@ void polyline_element::accept(const_visitor& v) const {
 }
 
 std::string polyline_shape::points_to_string() const {
-	std::stringstream s;
-	
+	std::string s;
+	this->append_points(s);
+	return s;
+}
+
+void polyline_shape::append_points(std::string& s)const{
 	bool isFirst = true;
 	for(auto& p : this->points){
 		if(isFirst){
 			isFirst = false;
 		}else{
-			s << ',';
+			s += ',';
 		}
-		s << p[0] << ',' << p[1];
+		append_real(s, p[0]);
+		s += ',';
+		append_real(s, p[1]);
 	}
-	return s.str();
 }
 
-decltype(path_element::path) path_element::parse(const std::string& str){
+decltype(path_element::path) path_element::parse(std::string_view str){
 	decltype(path_element::path) ret;
 	
 //	TRACE(<< "str = " << str << std::endl)
 	
-	std::istringstream s(str);
-	s >> std::skipws;
+	// steps are collected to temporary vectors and then copied to the packed path at once,
+	// rough estimate to avoid most reallocations
+	std::vector<real> coordinates;
+	coordinates.reserve(str.size() / 4);
+	std::vector<uint8_t> commands;
+	commands.reserve(str.size() / 16);
+
+	string_parser p(str);
 	
-	skip_whitespaces(s);
+	p.skip_whitespaces();
 	
 	step::type curType = step::type::unknown;
 	
-	while(!s.eof()){
-		ASSERT(!std::isspace(s.peek()))//spaces should be skept
+	while(!p.empty()){
+		ASSERT(!is_whitespace(p.peek_char()))//spaces should be skept
 		
-//		TRACE(<< "s.peek() = " << char(s.peek()) << std::endl)
+//		TRACE(<< "p.peek_char() = " << p.peek_char() << std::endl)
 		
 		{
-			auto t = step::char_to_type(s.peek());
+			auto t = step::char_to_type(p.peek_char());
 			if(t != step::type::unknown){
 				curType = t;
-				s.get();
+				p.read_char();
+			}else if(curType == step::type::close){
+				break; // command is expected after close path command
 			}else if(curType == step::type::unknown){
 				curType = step::type::move_abs;
 			}else if(curType == step::type::move_abs){
@@ -120,208 +137,100 @@ decltype(path_element::path) path_element::parse(const std::string& str){
 			}
 		}
 		
-		skip_whitespaces(s);
+		p.skip_whitespaces();
 		
-		step cur_step;
-		cur_step.type_ = curType;
-		
-		switch(cur_step.type_){
-			case step::type::move_abs:
-			case step::type::move_rel:
-			case step::type::line_abs:
-			case step::type::line_rel:
-				cur_step.x = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-//				TRACE(<< "cur_step.x = " << cur_step.x << std::endl)
-				skip_whitespaces_and_comma(s);
-				cur_step.y = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-//				TRACE(<< "cur_step.y = " << cur_step.y << std::endl)
-				break;
-			case step::type::close:
-				break;
-			case step::type::horizontal_line_abs:
-			case step::type::horizontal_line_rel:
-				cur_step.x = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				break;
-			case step::type::vertical_line_abs:
-			case step::type::vertical_line_rel:
-				cur_step.y = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				break;
-			case step::type::cubic_abs:
-			case step::type::cubic_rel:
-				cur_step.x1 = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.y1 = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.x2 = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.y2 = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.x = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.y = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				break;
-			case step::type::cubic_smooth_abs:
-			case step::type::cubic_smooth_rel:
-				cur_step.x2 = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.y2 = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.x = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.y = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				break;
-			case step::type::quadratic_abs:
-			case step::type::quadratic_rel:
-				cur_step.x1 = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.y1 = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.x = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.y = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				break;
-			case step::type::quadratic_smooth_abs:
-			case step::type::quadratic_smooth_rel:
-				cur_step.x = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.y = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				break;
-			case step::type::arc_abs:
-			case step::type::arc_rel:
-				cur_step.rx = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.ry = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.x_axis_rotation = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				{
-					char f;
-					s >> f;
-					if(s.fail()){
-						return ret;
-					}
-					cur_step.flags.large_arc = (f != '0');
-				}
-				skip_whitespaces_and_comma(s);
-				{
-					char f;
-					s >> f;
-					if(s.fail()){
-						return ret;
-					}
-					cur_step.flags.sweep = (f != '0');
-				}
-				skip_whitespaces_and_comma(s);
-				cur_step.x = read_in_real(s);
-				if(s.fail()){
-					return ret;
+		// coordinates are read directly into packed storage, partially read step is discarded
+		auto num_coordinates = packed_path::num_coordinates(curType);
+		auto command = uint8_t(curType);
+		auto coordinates_size = coordinates.size();
+
+		// If the string ends in the middle of the step, then missing coordinates are zeros.
+		// If there is something else than a number, then the step is discarded.
+		auto read_coordinate = [&p, &coordinates](){
+			if(auto v = p.try_read_real()){
+				coordinates.push_back(*v);
+				return true;
+			}
+			p.skip_whitespaces_and_comma();
+			if(p.empty()){
+				coordinates.push_back(0);
+				return true;
+			}
+			return false;
+		};
+
+		// arc flags are single characters, there is no default for them
+		auto read_flag = [&p, &command](uint8_t bit){
+			p.skip_whitespaces_and_comma();
+			if(p.empty()){
+				return false;
+			}
+			if(p.read_char() != '0'){
+				command |= bit;
+			}
+			return true;
+		};
+
+		bool ok = true;
+		if(curType == step::type::arc_abs || curType == step::type::arc_rel){
+			for(unsigned i = 0; ok && i != 3; ++i){
+				if(i != 0){
+					p.skip_whitespaces_and_comma();
 				}
-				skip_whitespaces_and_comma(s);
-				cur_step.y = read_in_real(s);
-				if(s.fail()){
-					return ret;
+				ok = read_coordinate();
+			}
+			ok = ok && read_flag(packed_path::large_arc_bit) && read_flag(packed_path::sweep_bit);
+			for(unsigned i = 0; ok && i != 2; ++i){
+				p.skip_whitespaces_and_comma();
+				ok = read_coordinate();
+			}
+		}else{
+			for(size_t i = 0; ok && i != num_coordinates; ++i){
+				if(i != 0){
+					p.skip_whitespaces_and_comma();
 				}
-				break;
-			default:
-				ASSERT(false)
-				break;
+				ok = read_coordinate();
+			}
+		}
+
+		if(!ok){
+			coordinates.resize(coordinates_size);
+			break;
 		}
 		
-		ret.push_back(cur_step);
+		commands.push_back(command);
 		
-		skip_whitespaces_and_comma(s);
+		p.skip_whitespaces_and_comma();
 	}
 	
+	ret.assign_unchecked(utki::make_span(commands), utki::make_span(coordinates));
 	return ret;
 }
 
 std::string path_element::path_to_string() const {
-	std::stringstream s;
+	std::string s;
+	this->append_path(s);
+	return s;
+}
+
+void path_element::append_path(std::string& s)const{
+	s.reserve(s.size() + this->path.coordinates().size() * 8); // rough estimate to avoid most reallocations
 	
 	step::type curType = step::type::unknown;
 
 	bool first = true;
 	
-	for(auto& cur_step : this->path){
+	for(auto cur_step : this->path){
 		if(curType == cur_step.type_){
-			s << " ";
+			s += ' ';
 		}else{
 			if (first) {
 				first = false;
 			} else {
-				s << " ";
+				s += ' ';
 			}
 			
-			s << step::type_to_char(cur_step.type_);
+			s += step::type_to_char(cur_step.type_);
 			curType = cur_step.type_;
 		}
 		
@@ -330,82 +239,81 @@ std::string path_element::path_to_string() const {
 			case step::type::move_rel:
 			case step::type::line_abs:
 			case step::type::line_rel:
-				s << cur_step.x;
-				s << ",";
-				s << cur_step.y;
+				append_real(s, cur_step.x);
+				s += ',';
+				append_real(s, cur_step.y);
 				break;
 			case step::type::close:
 				break;
 			case step::type::horizontal_line_abs:
 			case step::type::horizontal_line_rel:
-				s << cur_step.x;
+				append_real(s, cur_step.x);
 				break;
 			case step::type::vertical_line_abs:
 			case step::type::vertical_line_rel:
-				s << cur_step.y;
+				append_real(s, cur_step.y);
 				break;
 			case step::type::cubic_abs:
 			case step::type::cubic_rel:
-				s << cur_step.x1;
-				s << ",";
-				s << cur_step.y1;
-				s << " ";
-				s << cur_step.x2;
-				s << ",";
-				s << cur_step.y2;
-				s << " ";
-				s << cur_step.x;
-				s << ",";
-				s << cur_step.y;
+				append_real(s, cur_step.x1);
+				s += ',';
+				append_real(s, cur_step.y1);
+				s += ' ';
+				append_real(s, cur_step.x2);
+				s += ',';
+				append_real(s, cur_step.y2);
+				s += ' ';
+				append_real(s, cur_step.x);
+				s += ',';
+				append_real(s, cur_step.y);
 				break;
 			case step::type::cubic_smooth_abs:
 			case step::type::cubic_smooth_rel:
-				s << cur_step.x2;
-				s << ",";
-				s << cur_step.y2;
-				s << " ";
-				s << cur_step.x;
-				s << ",";
-				s << cur_step.y;
+				append_real(s, cur_step.x2);
+				s += ',';
+				append_real(s, cur_step.y2);
+				s += ' ';
+				append_real(s, cur_step.x);
+				s += ',';
+				append_real(s, cur_step.y);
 				break;
 			case step::type::quadratic_abs:
 			case step::type::quadratic_rel:
-				s << cur_step.x1;
-				s << ",";
-				s << cur_step.y1;
-				s << " ";
-				s << cur_step.x;
-				s << ",";
-				s << cur_step.y;
+				append_real(s, cur_step.x1);
+				s += ',';
+				append_real(s, cur_step.y1);
+				s += ' ';
+				append_real(s, cur_step.x);
+				s += ',';
+				append_real(s, cur_step.y);
 				break;
 			case step::type::quadratic_smooth_abs:
 			case step::type::quadratic_smooth_rel:
-				s << cur_step.x;
-				s << ",";
-				s << cur_step.y;
+				append_real(s, cur_step.x);
+				s += ',';
+				append_real(s, cur_step.y);
 				break;
 			case step::type::arc_abs:
 			case step::type::arc_rel:
-				s << cur_step.rx;
-				s << ",";
-				s << cur_step.ry;
-				s << " ";
-				s << cur_step.x_axis_rotation;
-				s << " ";
-				s << (cur_step.flags.large_arc ? "1" : "0");
-				s << ",";
-				s << (cur_step.flags.sweep ? "1" : "0");
-				s << " ";
-				s << cur_step.x;
-				s << ",";
-				s << cur_step.y;
+				append_real(s, cur_step.rx);
+				s += ',';
+				append_real(s, cur_step.ry);
+				s += ' ';
+				append_real(s, cur_step.x_axis_rotation);
+				s += ' ';
+				s += cur_step.flags.large_arc ? '1' : '0';
+				s += ',';
+				s += cur_step.flags.sweep ? '1' : '0';
+				s += ' ';
+				append_real(s, cur_step.x);
+				s += ',';
+				append_real(s, cur_step.y);
 				break;
 			default:
 				ASSERT(false)
 				break;
 		}
 	}
-	return s.str();
 }
 
 
@@ -501,29 +409,415 @@ path_element::step::type path_element::step::char_to_type(char c){
 	}
 }
 
-decltype(polyline_shape::points) polyline_shape::parse(const std::string& str) {
+path_element::step path_element::packed_path::unpack(uint8_t command, const real* coordinates)noexcept{
+	step ret{};
+	ret.type_ = step::type(command & type_mask);
+
+	switch(ret.type_){
+		case step::type::move_abs:
+		case step::type::move_rel:
+		case step::type::line_abs:
+		case step::type::line_rel:
+		case step::type::quadratic_smooth_abs:
+		case step::type::quadratic_smooth_rel:
+			ret.x = coordinates[0];
+			ret.y = coordinates[1];
+			break;
+		case step::type::horizontal_line_abs:
+		case step::type::horizontal_line_rel:
+			ret.x = coordinates[0];
+			break;
+		case step::type::vertical_line_abs:
+		case step::type::vertical_line_rel:
+			ret.y = coordinates[0];
+			break;
+		case step::type::cubic_abs:
+		case step::type::cubic_rel:
+			ret.x1 = coordinates[0];
+			ret.y1 = coordinates[1];
+			ret.x2 = coordinates[2];
+			ret.y2 = coordinates[3];
+			ret.x = coordinates[4];
+			ret.y = coordinates[5];
+			break;
+		case step::type::cubic_smooth_abs:
+		case step::type::cubic_smooth_rel:
+			ret.x2 = coordinates[0];
+			ret.y2 = coordinates[1];
+			ret.x = coordinates[2];
+			ret.y = coordinates[3];
+			break;
+		case step::type::quadratic_abs:
+		case step::type::quadratic_rel:
+			ret.x1 = coordinates[0];
+			ret.y1 = coordinates[1];
+			ret.x = coordinates[2];
+			ret.y = coordinates[3];
+			break;
+		case step::type::arc_abs:
+		case step::type::arc_rel:
+			ret.rx = coordinates[0];
+			ret.ry = coordinates[1];
+			ret.x_axis_rotation = coordinates[2];
+			ret.flags.large_arc = (command & large_arc_bit) != 0;
+			ret.flags.sweep = (command & sweep_bit) != 0;
+			ret.x = coordinates[3];
+			ret.y = coordinates[4];
+			break;
+		default:
+			break;
+	}
+
+	return ret;
+}
+
+uint8_t path_element::packed_path::pack(const step& s, real* c)noexcept{
+	auto command = uint8_t(s.type_);
+	ASSERT((command & type_mask) == command)
+
+	switch(s.type_){
+		case step::type::move_abs:
+		case step::type::move_rel:
+		case step::type::line_abs:
+		case step::type::line_rel:
+		case step::type::quadratic_smooth_abs:
+		case step::type::quadratic_smooth_rel:
+			c[0] = s.x;
+			c[1] = s.y;
+			break;
+		case step::type::horizontal_line_abs:
+		case step::type::horizontal_line_rel:
+			c[0] = s.x;
+			break;
+		case step::type::vertical_line_abs:
+		case step::type::vertical_line_rel:
+			c[0] = s.y;
+			break;
+		case step::type::cubic_abs:
+		case step::type::cubic_rel:
+			c[0] = s.x1;
+			c[1] = s.y1;
+			c[2] = s.x2;
+			c[3] = s.y2;
+			c[4] = s.x;
+			c[5] = s.y;
+			break;
+		case step::type::cubic_smooth_abs:
+		case step::type::cubic_smooth_rel:
+			c[0] = s.x2;
+			c[1] = s.y2;
+			c[2] = s.x;
+			c[3] = s.y;
+			break;
+		case step::type::quadratic_abs:
+		case step::type::quadratic_rel:
+			c[0] = s.x1;
+			c[1] = s.y1;
+			c[2] = s.x;
+			c[3] = s.y;
+			break;
+		case step::type::arc_abs:
+		case step::type::arc_rel:
+			c[0] = s.rx;
+			c[1] = s.ry;
+			c[2] = s.x_axis_rotation;
+			c[3] = s.x;
+			c[4] = s.y;
+			if(s.flags.large_arc){
+				command |= large_arc_bit;
+			}
+			if(s.flags.sweep){
+				command |= sweep_bit;
+			}
+			break;
+		default:
+			break;
+	}
+
+	return command;
+}
+
+void path_element::packed_path::push_back(const step& s){
+	auto n = num_coordinates(s.type_);
+	this->reserve_more(1, n);
+
+	auto b = this->data;
+	auto command = pack(s, b->coordinates() + b->num_coordinates);
+
+	b->num_coordinates += uint32_t(n);
+	b->commands()[b->num_commands] = command;
+	++b->num_commands;
+}
+
+size_t path_element::packed_path::coordinate_offset(const buffer& b, size_t i)noexcept{
+	ASSERT(i <= b.num_commands)
+	size_t ret = 0;
+	auto commands = b.commands();
+	for(size_t j = 0; j != i; ++j){
+		ret += num_coordinates(step::type(commands[j] & type_mask));
+	}
+	return ret;
+}
+
+path_element::step path_element::packed_path::operator[](size_t i)const{
+	auto b = this->get_buffer();
+	ASSERT(b && i < b->num_commands)
+	return unpack(b->commands()[i], b->coordinates() + coordinate_offset(*b, i));
+}
+
+path_element::step path_element::packed_path::back()const{
+	auto b = this->get_buffer();
+	ASSERT(b && b->num_commands != 0)
+	auto command = b->commands()[b->num_commands - 1];
+	return unpack(command, b->coordinates() + b->num_coordinates - num_coordinates(step::type(command & type_mask)));
+}
+
+void path_element::packed_path::set(size_t i, const step& s){
+	this->ensure_parsed();
+	ASSERT(this->data && i < this->data->num_commands)
+
+	auto offset = coordinate_offset(*this->data, i);
+	auto old_n = num_coordinates(step::type(this->data->commands()[i] & type_mask));
+	auto n = num_coordinates(s.type_);
+
+	// makes sure the memory block is not shared
+	this->reserve_more(0, n > old_n ? n - old_n : 0);
+
+	auto b = this->data;
+	auto c = b->coordinates() + offset;
+	auto end = b->coordinates() + b->num_coordinates;
+	if(n > old_n){
+		std::copy_backward(c + old_n, end, end + (n - old_n));
+	}else if(n < old_n){
+		std::copy(c + old_n, end, c + n);
+	}
+	b->num_coordinates = uint32_t(b->num_coordinates + n - old_n);
+
+	b->commands()[i] = pack(s, c);
+}
+
+path_element::packed_path::packed_path(const std::vector<step>& steps){
+	size_t n = 0;
+	for(auto& s : steps){
+		n += num_coordinates(s.type_);
+	}
+	this->reserve_more(steps.size(), n);
+	for(auto& s : steps){
+		this->push_back(s);
+	}
+}
+
+path_element::packed_path::packed_path(const packed_path& p){
+	this->operator=(p);
+}
+
+path_element::packed_path& path_element::packed_path::operator=(const packed_path& p){
+	if(this == &p){
+		return *this;
+	}
+	auto b = p.get_buffer();
+	this->lazy.reset();
+	this->release();
+	if(b){
+		// only the reference counter of the memory block is changed, the original path is left intact
+		p.data->refs.add_ref();
+		this->data = p.data;
+	}
+	return *this;
+}
+
+path_element::packed_path::packed_path(packed_path&& p)noexcept :
+		data(p.data),
+		lazy(std::move(p.lazy))
+{
+	p.data = nullptr;
+}
+
+path_element::packed_path& path_element::packed_path::operator=(packed_path&& p)noexcept{
+	if(this == &p){
+		return *this;
+	}
+	this->release();
+	this->data = p.data;
+	p.data = nullptr;
+	this->lazy = std::move(p.lazy);
+	return *this;
+}
+
+void path_element::packed_path::release()noexcept{
+	if(!this->data){
+		return;
+	}
+	if(this->data->refs.release()){
+		this->data->~buffer();
+		::operator delete(this->data);
+	}
+	this->data = nullptr;
+}
+
+void path_element::packed_path::reallocate(size_t command_capacity, size_t coordinate_capacity){
+	if(command_capacity > std::numeric_limits<uint32_t>::max() || coordinate_capacity > std::numeric_limits<uint32_t>::max()){
+		throw std::length_error("packed_path: too many steps");
+	}
+
+	auto b = new(::operator new(sizeof(buffer) + coordinate_capacity * sizeof(real) + command_capacity)) buffer;
+	b->command_capacity = uint32_t(command_capacity);
+	b->coordinate_capacity = uint32_t(coordinate_capacity);
+
+	if(auto old = this->data){
+		ASSERT(old->num_commands <= command_capacity && old->num_coordinates <= coordinate_capacity)
+		b->num_commands = old->num_commands;
+		b->num_coordinates = old->num_coordinates;
+		std::copy_n(old->commands(), old->num_commands, b->commands());
+		std::copy_n(old->coordinates(), old->num_coordinates, b->coordinates());
+	}else{
+		b->num_commands = 0;
+		b->num_coordinates = 0;
+	}
+
+	this->release();
+	this->data = b;
+}
+
+void path_element::packed_path::reserve_more(size_t num_commands, size_t num_coordinates){
+	this->ensure_parsed();
+
+	auto b = this->data;
+	if(!b){
+		this->reallocate(num_commands, num_coordinates);
+		return;
+	}
+
+	size_t commands_needed = size_t(b->num_commands) + num_commands;
+	size_t coordinates_needed = size_t(b->num_coordinates) + num_coordinates;
+
+	bool fits = commands_needed <= b->command_capacity && coordinates_needed <= b->coordinate_capacity;
+
+	if(fits && !b->refs.is_shared()){
+		return;
+	}
+
+	// grow geometrically to make appending steps one by one amortized constant time
+	auto grow = [](size_t needed, size_t capacity){
+		return needed <= capacity ? capacity : std::max(needed, capacity * 2);
+	};
+
+	this->reallocate(
+			grow(commands_needed, b->command_capacity),
+			grow(coordinates_needed, b->coordinate_capacity)
+		);
+}
+
+void path_element::packed_path::assign_unchecked(utki::span<const uint8_t> commands, utki::span<const real> coordinates){
+	this->lazy.reset();
+	this->release();
+	if(commands.empty()){
+		return;
+	}
+	this->reallocate(commands.size(), coordinates.size());
+	auto b = this->data;
+	std::copy(commands.begin(), commands.end(), b->commands());
+	std::copy(coordinates.begin(), coordinates.end(), b->coordinates());
+	b->num_commands = uint32_t(commands.size());
+	b->num_coordinates = uint32_t(coordinates.size());
+}
+
+void path_element::packed_path::ensure_parsed()const{
+	this->lazy.parse_once([this](std::string_view str){
+		auto p = path_element::parse(str);
+		ASSERT(!this->data)
+		this->data = p.data;
+		p.data = nullptr;
+	});
+}
+
+void path_element::packed_path::set_lazy(std::string str){
+	this->release();
+	this->lazy.set(std::move(str));
+}
+
+std::vector<path_element::step> path_element::packed_path::to_steps()const{
+	return std::vector<step>(this->begin(), this->end());
+}
+
+void path_element::packed_path::shrink_to_fit(){
+	this->ensure_parsed();
+	auto b = this->data;
+	if(!b){
+		return;
+	}
+	if(b->num_commands == 0){
+		this->release();
+		return;
+	}
+	if(b->num_commands != b->command_capacity || b->num_coordinates != b->coordinate_capacity){
+		this->reallocate(b->num_commands, b->num_coordinates);
+	}
+}
+
+void path_element::packed_path::unshare(){
+	this->ensure_parsed();
+	auto b = this->data;
+	if(b && b->refs.is_shared()){
+		this->reallocate(b->command_capacity, b->coordinate_capacity);
+	}
+}
+
+void path_element::packed_path::assign(utki::span<const uint8_t> commands, utki::span<const real> coordinates){
+	size_t expected_num_coordinates = 0;
+	for(auto c : commands){
+		if(!is_valid_command(c)){
+			throw std::invalid_argument("packed_path::assign(): invalid command byte");
+		}
+		expected_num_coordinates += num_coordinates(step::type(c & type_mask));
+	}
+	if(expected_num_coordinates != coordinates.size()){
+		throw std::invalid_argument("packed_path::assign(): number of coordinates does not match the commands");
+	}
+
+	this->assign_unchecked(commands, coordinates);
+}
+
+bool path_element::packed_path::operator==(const packed_path& p)const{
+	auto commands = this->commands();
+	auto p_commands = p.commands();
+	auto coordinates = this->coordinates();
+	auto p_coordinates = p.coordinates();
+	return std::equal(commands.begin(), commands.end(), p_commands.begin(), p_commands.end())
+			&& std::equal(coordinates.begin(), coordinates.end(), p_coordinates.begin(), p_coordinates.end());
+}
+
+decltype(polyline_shape::points) polyline_shape::parse(std::string_view str) {
 	decltype(polyline_shape::points) ret;
 	
-	std::istringstream s(str);
-	s >> std::skipws;
+	string_parser p(str);
 	
-	skip_whitespaces(s);
+	p.skip_whitespaces();
 	
-	while(!s.eof()){
-		decltype(ret)::value_type p;
-		p[0] = read_in_real(s);
-		skip_whitespaces_and_comma(s);
-		p[1] = read_in_real(s);
-		
-		if(s.fail()){
+	while(!p.empty()){
+		decltype(ret)::value_type v;
+
+		auto x = p.try_read_real();
+		if(!x){
+			break;
+		}
+		v[0] = *x;
+
+		p.skip_whitespaces_and_comma();
+
+		// if the string ends after x, then y is zero
+		if(p.empty()){
+			v[1] = 0;
+		}else if(auto y = p.try_read_real()){
+			v[1] = *y;
+		}else{
 			break;
 		}
 		
-		ret.push_back(p);
+		ret.push_back(v);
 		
-		skip_whitespaces_and_comma(s);
+		p.skip_whitespaces_and_comma();
 	}
 	
 	return ret;
 }
-
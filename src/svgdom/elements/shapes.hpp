@@ -4,6 +4,14 @@
 #include "styleable.hpp"
 #include "element.hpp"
 #include "rectangle.hpp"
+#include "lazy_attribute.hpp"
+#include "ref_counter.hpp"
+
+#include <vector>
+#include <iterator>
+#include <memory>
+
+#include <utki/span.hpp>
 
 #include <r4/vector2.hpp>
 
@@ -79,12 +87,369 @@ struct path_element : public shape{
 		static char type_to_char(type t);
 	};
 
-	std::vector<step> path;
+	/**
+	 * @brief Compact storage of path steps.
+	 * Steps are stored as a stream of command bytes and a contiguous array of
+	 * coordinates, each step only takes as many coordinates as its command needs.
+	 * For example, close path step takes one byte and line step takes one byte
+	 * plus two coordinates, as opposed to the fixed size of the step structure.
+	 * Arc flags are packed into the command byte.
+	 * Command bytes and coordinates are kept in a single memory block together with
+	 * their sizes, so the packed path object itself is just a pointer to that block
+	 * plus the lazy parsing state, and empty path allocates nothing.
+	 * For example, 2064 path data attributes of the test corpus take 389200 bytes of heap memory
+	 * when packed, against 656864 bytes when stored as std::vector of steps, which is about 1.7 times
+	 * less, and the packed path object is 16 bytes against 24 bytes of std::vector.
+	 * Steps can be iterated as step structures, which are unpacked on the fly.
+	 * The raw command bytes and coordinates are accessible via commands() and coordinates().
+	 * Copies share the memory block with the original until either of them is modified,
+	 * so copying is cheap, see also unshare(). The memory block is reference counted, so copying
+	 * does not change the original path in any other way and several threads can copy the same
+	 * path simultaneously. Steps are only accessible by value, so sharing is not observable
+	 * except via pointers returned by commands() and coordinates().
+	 */
+	class packed_path{
+		friend struct path_element;
+
+		// Header of the memory block, followed by coordinates and then by command bytes.
+		struct alignas(alignof(real)) buffer{
+			ref_counter refs;
+			uint32_t num_commands;
+			uint32_t command_capacity;
+			uint32_t num_coordinates;
+			uint32_t coordinate_capacity;
+
+			real* coordinates()noexcept{
+				return reinterpret_cast<real*>(this + 1);
+			}
+
+			const real* coordinates()const noexcept{
+				return reinterpret_cast<const real*>(this + 1);
+			}
+
+			uint8_t* commands()noexcept{
+				return reinterpret_cast<uint8_t*>(this->coordinates() + this->coordinate_capacity);
+			}
+
+			const uint8_t* commands()const noexcept{
+				return reinterpret_cast<const uint8_t*>(this->coordinates() + this->coordinate_capacity);
+			}
+		};
+
+		// mutable because lazily parsed path is filled in on first access
+		mutable buffer* data = nullptr;
+
+		lazy_attribute lazy;
+
+		void ensure_parsed()const;
+
+		const buffer* get_buffer()const{
+			this->ensure_parsed();
+			return this->data;
+		}
+
+		// drop reference to the memory block
+		void release()noexcept;
+
+		// move steps to a new memory block of given capacity
+		void reallocate(size_t command_capacity, size_t coordinate_capacity);
+
+		// make sure the memory block is not shared and has room for more steps
+		void reserve_more(size_t num_commands, size_t num_coordinates);
+
+		// replace steps without checking that the number of coordinates matches the commands
+		void assign_unchecked(utki::span<const uint8_t> commands, utki::span<const real> coordinates);
+
+		// index of the first coordinate of the step
+		static size_t coordinate_offset(const buffer& b, size_t i)noexcept;
+
+		// write coordinates of the step, returns command byte
+		static uint8_t pack(const step& s, real* coordinates)noexcept;
+
+	public:
+		/**
+		 * @brief Bits of the command byte holding the step type.
+		 */
+		constexpr static uint8_t type_mask = 0x1f;
+
+		/**
+		 * @brief Bit of the command byte holding the large arc flag of arc step.
+		 */
+		constexpr static uint8_t large_arc_bit = 0x20;
+
+		/**
+		 * @brief Bit of the command byte holding the sweep flag of arc step.
+		 */
+		constexpr static uint8_t sweep_bit = 0x40;
+
+		/**
+		 * @brief Get number of coordinates stored for a step type.
+		 * Coordinates are stored in the same order as they appear in path data string,
+		 * e.g. for cubic step it is x1, y1, x2, y2, x, y and for arc step it is
+		 * rx, ry, x_axis_rotation, x, y.
+		 * @param t - step type.
+		 * @return number of coordinates.
+		 */
+		constexpr static size_t num_coordinates(step::type t)noexcept{
+			switch(t){
+				default:
+				case step::type::unknown:
+				case step::type::close:
+					return 0;
+				case step::type::horizontal_line_abs:
+				case step::type::horizontal_line_rel:
+				case step::type::vertical_line_abs:
+				case step::type::vertical_line_rel:
+					return 1;
+				case step::type::move_abs:
+				case step::type::move_rel:
+				case step::type::line_abs:
+				case step::type::line_rel:
+				case step::type::quadratic_smooth_abs:
+				case step::type::quadratic_smooth_rel:
+					return 2;
+				case step::type::cubic_smooth_abs:
+				case step::type::cubic_smooth_rel:
+				case step::type::quadratic_abs:
+				case step::type::quadratic_rel:
+					return 4;
+				case step::type::arc_abs:
+				case step::type::arc_rel:
+					return 5;
+				case step::type::cubic_abs:
+				case step::type::cubic_rel:
+					return 6;
+			}
+		}
+
+		/**
+		 * @brief Check command byte.
+		 * @param command - command byte to check.
+		 * @return true if the command byte holds a known step type and no flags other than arc flags of arc step.
+		 */
+		constexpr static bool is_valid_command(uint8_t command)noexcept{
+			auto t = step::type(command & type_mask);
+			if(t == step::type::unknown || t > step::type::arc_rel){
+				return false;
+			}
+			uint8_t allowed_bits = type_mask;
+			if(t == step::type::arc_abs || t == step::type::arc_rel){
+				allowed_bits |= large_arc_bit | sweep_bit;
+			}
+			return (command & ~allowed_bits) == 0;
+		}
+
+		/**
+		 * @brief Unpack step.
+		 * @param command - command byte of the step.
+		 * @param coordinates - pointer to the first coordinate of the step.
+		 * @return unpacked step. Members not used by the step type are set to zero.
+		 */
+		static step unpack(uint8_t command, const real* coordinates)noexcept;
+
+		class const_iterator{
+			friend class packed_path;
+
+			const uint8_t* command;
+			const real* coordinates;
+
+			const_iterator(const uint8_t* command, const real* coordinates) :
+					command(command),
+					coordinates(coordinates)
+			{}
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef step value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef void pointer;
+			typedef step reference;
+
+			const_iterator() = default;
+
+			step operator*()const noexcept{
+				return unpack(*this->command, this->coordinates);
+			}
+
+			const_iterator& operator++()noexcept{
+				this->coordinates += num_coordinates(step::type(*this->command & type_mask));
+				++this->command;
+				return *this;
+			}
+
+			const_iterator operator++(int)noexcept{
+				auto ret = *this;
+				++(*this);
+				return ret;
+			}
+
+			bool operator==(const const_iterator& i)const noexcept{
+				return this->command == i.command;
+			}
+
+			bool operator!=(const const_iterator& i)const noexcept{
+				return this->command != i.command;
+			}
+		};
+
+		packed_path() = default;
+
+		packed_path(const packed_path& p);
+		packed_path& operator=(const packed_path& p);
+
+		packed_path(packed_path&& p)noexcept;
+		packed_path& operator=(packed_path&& p)noexcept;
+
+		~packed_path()noexcept{
+			this->release();
+		}
+
+		/**
+		 * @brief Construct packed path from unpacked steps.
+		 * @param steps - steps to pack.
+		 */
+		packed_path(const std::vector<step>& steps);
+
+		/**
+		 * @brief Unpack all steps.
+		 * @return vector of unpacked steps.
+		 */
+		std::vector<step> to_steps()const;
+
+		const_iterator begin()const{
+			auto commands = this->commands();
+			auto coordinates = this->coordinates();
+			return const_iterator(commands.data(), coordinates.data());
+		}
+
+		const_iterator end()const{
+			auto commands = this->commands();
+			auto coordinates = this->coordinates();
+			return const_iterator(commands.data() + commands.size(), coordinates.data() + coordinates.size());
+		}
+
+		/**
+		 * @brief Get number of steps.
+		 * @return number of steps.
+		 */
+		size_t size()const{
+			auto b = this->get_buffer();
+			return b ? b->num_commands : 0;
+		}
+
+		bool empty()const{
+			return this->size() == 0;
+		}
+
+		void clear()noexcept{
+			this->lazy.reset();
+			this->release();
+		}
+
+		/**
+		 * @brief Get step.
+		 * Steps have different number of coordinates, so finding the step takes time linear to its index.
+		 * Use iterators for sequential access.
+		 * @param i - index of the step, must be less than size().
+		 * @return unpacked step.
+		 */
+		step operator[](size_t i)const;
+
+		/**
+		 * @brief Get last step.
+		 * The path must not be empty.
+		 * @return unpacked last step.
+		 */
+		step back()const;
+
+		/**
+		 * @brief Replace step.
+		 * Finding the step takes time linear to its index. In case the new step has different
+		 * number of coordinates than the old one, coordinates of the following steps are moved.
+		 * @param i - index of the step to replace, must be less than size().
+		 * @param s - new step.
+		 */
+		void set(size_t i, const step& s);
+
+		/**
+		 * @brief Append step.
+		 * @param s - step to append.
+		 */
+		void push_back(const step& s);
+
+		/**
+		 * @brief Free unused capacity.
+		 */
+		void shrink_to_fit();
+
+		/**
+		 * @brief Make own copy of the steps if the memory block is shared with other copies.
+		 */
+		void unshare();
+
+		/**
+		 * @brief Replace steps with already packed ones.
+		 * @param commands - command bytes, one per step, see commands().
+		 * @param coordinates - coordinates of all the steps, see coordinates().
+		 * @throw std::invalid_argument - in case a command byte is invalid or number of coordinates does not match the commands.
+		 */
+		void assign(utki::span<const uint8_t> commands, utki::span<const real> coordinates);
+
+		/**
+		 * @brief Set path data string to be parsed on first access.
+		 * Replaces current steps.
+		 * @param str - path data string, i.e. value of 'd' attribute.
+		 */
+		void set_lazy(std::string str);
+
+		/**
+		 * @brief Get command bytes.
+		 * One byte per step, see type_mask, large_arc_bit and sweep_bit.
+		 * @return command bytes.
+		 */
+		utki::span<const uint8_t> commands()const{
+			auto b = this->get_buffer();
+			if(!b){
+				return utki::span<const uint8_t>();
+			}
+			return utki::make_span(b->commands(), b->num_commands);
+		}
+
+		/**
+		 * @brief Get coordinates of all steps.
+		 * @return coordinates.
+		 */
+		utki::span<const real> coordinates()const{
+			auto b = this->get_buffer();
+			if(!b){
+				return utki::span<const real>();
+			}
+			return utki::make_span(b->coordinates(), b->num_coordinates);
+		}
+
+		bool operator==(const packed_path& p)const;
+
+		bool operator!=(const packed_path& p)const{
+			return !this->operator==(p);
+		}
+	};
+
+	packed_path path;
 	
 	std::string path_to_string()const;
+
+	/**
+	 * @brief Append path data to string.
+	 * Appends the path in the format of 'd' attribute value.
+	 * @param s - string to append the path data to.
+	 */
+	void append_path(std::string& s)const;
 	
-	static decltype(path) parse(const std::string& str);
+	static decltype(path) parse(std::string_view str);
 	
+	path_element(){
+		this->type_tag = element_type::path;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -102,6 +467,10 @@ struct rect_element :
 	length rx = length(0, length_unit::unknown);
 	length ry = length(0, length_unit::unknown);
 	
+	rect_element(){
+		this->type_tag = element_type::rect;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -126,6 +495,10 @@ struct circle_element : public shape{
 	length cy = length(0, length_unit::unknown);
 	length r = length(0, length_unit::unknown);
 	
+	circle_element(){
+		this->type_tag = element_type::circle;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -142,6 +515,10 @@ struct ellipse_element : public shape{
 	length rx = length(0, length_unit::unknown);
 	length ry = length(0, length_unit::unknown);
 	
+	ellipse_element(){
+		this->type_tag = element_type::ellipse;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -158,6 +535,10 @@ struct line_element : public shape{
 	length x2 = length(0, length_unit::unknown);
 	length y2 = length(0, length_unit::unknown);
 	
+	line_element(){
+		this->type_tag = element_type::line;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -173,10 +554,21 @@ struct polyline_shape : public shape{
 	
 	std::string points_to_string()const;
 
-	static decltype(points) parse(const std::string& str);
+	/**
+	 * @brief Append points to string.
+	 * Appends the points in the format of 'points' attribute value.
+	 * @param s - string to append the points to.
+	 */
+	void append_points(std::string& s)const;
+
+	static decltype(points) parse(std::string_view str);
 };
 
 struct polyline_element : public polyline_shape{
+	polyline_element(){
+		this->type_tag = element_type::polyline;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -188,6 +580,10 @@ struct polyline_element : public polyline_shape{
 };
 
 struct polygon_element : public polyline_shape{
+	polygon_element(){
+		this->type_tag = element_type::polygon;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -17,6 +17,10 @@ struct g_element :
 		public transformable,
 		public styleable
 {
+	g_element(){
+		this->type_tag = element_type::g;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -37,6 +41,10 @@ struct defs_element :
 		public transformable,
 		public styleable
 {
+	defs_element(){
+		this->type_tag = element_type::defs;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -58,6 +66,10 @@ struct use_element :
 		public rectangle,
 		public styleable
 {
+	use_element(){
+		this->type_tag = element_type::use;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -80,6 +92,10 @@ struct svg_element :
 		public aspect_ratioed,
 		public styleable
 {
+	svg_element(){
+		this->type_tag = element_type::svg;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -118,6 +134,10 @@ struct symbol_element :
 		public aspect_ratioed,
 		public styleable
 {
+	symbol_element(){
+		this->type_tag = element_type::symbol;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -138,10 +158,14 @@ struct mask_element :
 		public rectangle,
 		public styleable
 {
-	coordinate_units mask_units;
+	coordinate_units mask_units = coordinate_units::unknown;
 
-	coordinate_units mask_content_units;
+	coordinate_units mask_content_units = coordinate_units::unknown;
 	
+	mask_element(){
+		this->type_tag = element_type::mask;
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
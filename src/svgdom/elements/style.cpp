@@ -1,11 +1,163 @@
 #include "style.hpp"
 
+#include <utki/debug.hpp>
+
+#include <algorithm>
+#include <functional>
+
 #include "../visitor.hpp"
 
 using namespace svgdom;
 
 const std::string style_element::tag = "style";
 
+namespace{
+enum class bucket_kind{
+	none, // style without selectors never matches
+	id,
+	class_,
+	tag,
+	universal
+};
+
+std::pair<bucket_kind, const std::string*> get_bucket_key(const cssdom::style& style)noexcept{
+	if(style.selectors.empty()){
+		return {bucket_kind::none, nullptr};
+	}
+	const auto& s = style.selectors.back();
+	if(!s.id.empty()){
+		return {bucket_kind::id, &s.id};
+	}else if(!s.classes.empty()){
+		return {bucket_kind::class_, &s.classes.front()};
+	}else if(!s.tag.empty() && s.tag != "*"){
+		return {bucket_kind::tag, &s.tag};
+	}
+	return {bucket_kind::universal, nullptr};
+}
+
+size_t hash_keys(const cssdom::document& doc)noexcept{
+	size_t ret = 0;
+	for(const auto& style : doc.styles){
+		auto key = get_bucket_key(style);
+		size_t h = size_t(key.first);
+		if(key.second){
+			h ^= std::hash<std::string>()(*key.second) + 0x9e3779b9 + (h << 6) + (h >> 2);
+		}
+		ret ^= h + 0x9e3779b9 + (ret << 6) + (ret >> 2);
+	}
+	return ret;
+}
+}
+
+css_selector_index::css_selector_index(const cssdom::document& doc) :
+		num_styles(doc.styles.size()),
+		keys_hash(hash_keys(doc))
+{
+	auto b = std::make_shared<buckets>();
+
+	for(size_t i = 0; i != doc.styles.size(); ++i){
+		auto key = get_bucket_key(doc.styles[i]);
+		switch(key.first){
+			case bucket_kind::none:
+				break;
+			case bucket_kind::id:
+				b->by_id[*key.second].push_back(i);
+				break;
+			case bucket_kind::class_:
+				b->by_class[*key.second].push_back(i);
+				break;
+			case bucket_kind::tag:
+				b->by_tag[*key.second].push_back(i);
+				break;
+			case bucket_kind::universal:
+				b->universal.push_back(i);
+				break;
+		}
+	}
+
+	this->index = std::move(b);
+}
+
+bool css_selector_index::is_valid_for(const cssdom::document& doc)const noexcept{
+	return this->num_styles == doc.styles.size() && this->keys_hash == hash_keys(doc);
+}
+
+cssdom::document::property_value css_selector_index::get_property_value(
+		const cssdom::document& doc,
+		cssdom::xml_dom_crawler& crawler,
+		uint32_t property_id
+	)const
+{
+	ASSERT(this->is_valid_for(doc))
+
+	// Styles are stored in the order of precedence, so the matching style with the smallest
+	// position wins. Buckets are sorted, so each bucket is scanned up to the best match found so far.
+	size_t best = doc.styles.size();
+	const cssdom::property* best_property = nullptr;
+
+	auto scan = [&](const std::vector<size_t>& bucket){
+		for(auto i : bucket){
+			if(i >= best){
+				return;
+			}
+			const auto& style = doc.styles[i];
+			auto p = std::find_if(
+					style.properties.begin(),
+					style.properties.end(),
+					[property_id](const cssdom::property& p){
+						return p.id == property_id;
+					}
+				);
+			if(p == style.properties.end()){
+				continue;
+			}
+			crawler.reset();
+			if(!cssdom::document::is_match(style.selectors, crawler)){
+				continue;
+			}
+			best = i;
+			best_property = &*p;
+			return;
+		}
+	};
+
+	if(!this->index){
+		return cssdom::document::property_value{nullptr, 0};
+	}
+	const auto& b = *this->index;
+
+	crawler.reset();
+	const auto& e = crawler.get();
+
+	if(!e.get_id().empty()){
+		auto i = b.by_id.find(e.get_id());
+		if(i != b.by_id.end()){
+			scan(i->second);
+		}
+	}
+
+	for(const auto& c : e.get_classes()){
+		auto i = b.by_class.find(c);
+		if(i != b.by_class.end()){
+			scan(i->second);
+		}
+	}
+
+	{
+		auto i = b.by_tag.find(e.get_tag());
+		if(i != b.by_tag.end()){
+			scan(i->second);
+		}
+	}
+
+	scan(b.universal);
+
+	if(!best_property){
+		return cssdom::document::property_value{nullptr, 0};
+	}
+	return cssdom::document::property_value{best_property->value.get(), doc.styles[best].specificity};
+}
+
 void style_element::accept(visitor& v){
 	v.visit(*this);
 }
@@ -6,18 +6,89 @@
 #include <cssdom/dom.hpp>
 
 #include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
 
 namespace svgdom{
 
+/**
+ * @brief Index of CSS document styles by rightmost selector.
+ * Styles are bucketed by the id, the first class or the tag of their rightmost
+ * selector, whichever is present first in that order. When looking up a property
+ * for an element only the styles from the buckets of the element's id, classes and tag,
+ * plus the styles with universal rightmost selector, are evaluated.
+ * The index refers to styles by their position in the document, so it has to be
+ * rebuilt when styles of the document are changed. To detect that, the index keeps
+ * a hash of the bucket keys of all styles, see is_valid_for().
+ * The index is immutable once built, so copies of the index share the buckets.
+ */
+class css_selector_index{
+	size_t num_styles = 0;
+	size_t keys_hash = 0;
+
+	struct buckets{
+		std::unordered_map<std::string, std::vector<size_t>> by_id;
+		std::unordered_map<std::string, std::vector<size_t>> by_class;
+		std::unordered_map<std::string, std::vector<size_t>> by_tag;
+		std::vector<size_t> universal;
+	};
+
+	std::shared_ptr<const buckets> index;
+
+public:
+	css_selector_index() = default;
+
+	/**
+	 * @brief Build index for CSS document.
+	 * @param doc - CSS document to build index for.
+	 */
+	css_selector_index(const cssdom::document& doc);
+
+	/**
+	 * @brief Check if the index can be used for the CSS document.
+	 * Compares the number of styles and the hash of the bucket keys of the styles,
+	 * so the check takes time linear to the number of styles.
+	 * Changes to the style properties do not invalidate the index.
+	 * @param doc - CSS document to check.
+	 * @return true if the index was built for the document with the same styles.
+	 */
+	bool is_valid_for(const cssdom::document& doc)const noexcept;
+
+	/**
+	 * @brief Get property value for the element.
+	 * Gives same result as cssdom::document::get_property_value().
+	 * @param doc - CSS document the index was built for.
+	 * @param crawler - crawler pointing to the element to get property for.
+	 * @param property_id - id of the property to get.
+	 * @return property value and its specificity.
+	 */
+	cssdom::document::property_value get_property_value(
+			const cssdom::document& doc,
+			cssdom::xml_dom_crawler& crawler,
+			uint32_t property_id
+		)const;
+};
+
 struct style_element : public element{
 	cssdom::document css;
 
+	/**
+	 * @brief Selector index for the 'css' document.
+	 * Built by the parser when loading the document.
+	 */
+	css_selector_index selector_index;
+
 	struct css_style_value : public cssdom::property_value_base{
 		style_value value;
 	};
 
 	static const std::string tag;
 
+	style_element(){
+		this->type_tag = element_type::style;
+	}
+
 	void accept(visitor& v) override;
 	void accept(const_visitor& v) const override;
 };
@@ -1,17 +1,20 @@
 #include "styleable.hpp"
 
-#include <set>
-#include <iomanip>
+#include <algorithm>
+#include <optional>
 #include <cctype>
 #include <array>
 #include <cmath>
+#include <initializer_list>
+#include <utility>
+#include <memory>
 
 #include <utki/debug.hpp>
-#include <utki/util.hpp>
 
 #include "../util.hxx"
 #include "element.hpp"
 #include "../malformed_svg_error.hpp"
+#include "../perfect_hash.hxx"
 
 using namespace svgdom;
 
@@ -22,48 +25,44 @@ const char* current_color_word = "currentColor";
 }
 
 namespace{
-std::string stroke_dasharray_to_string(const style_value& v){
-	// special values must be already handled by styleable::style_value_to_string() at this point
+void append_stroke_dasharray(std::string& s, const style_value& v){
+	// special values must be already handled by styleable::append_style_value() at this point
 	ASSERT_INFO(!std::holds_alternative<style_value_special>(v), "v = " << unsigned(*std::get_if<style_value_special>(&v)))
 
 	if(!std::holds_alternative<std::vector<length>>(v)){
-		return std::string();
+		return;
 	}
 
-	std::stringstream ss;
-
-	auto dasharray = *std::get_if<std::vector<length>>(&v);
+	auto& dasharray = *std::get_if<std::vector<length>>(&v);
 
 	for(auto i = dasharray.begin(); i != dasharray.end(); ++i){
 		if(i != dasharray.begin()){
-			ss << " ";
+			s += ' ';
 		}
-		ss << (*i);
+		append_length(s, *i);
 	}
-
-	return ss.str();
 }
 }
 
 namespace{
-style_value parse_stroke_dasharray(const std::string& str){
+style_value parse_stroke_dasharray(std::string_view str){
 	// the "inherit" case is handled already by styleable::parse_style_property_value()
 	if(str == none_word){
 		return style_value(style_value_special::none);
 	}
 
-	std::istringstream iss(str);
+	string_parser p(str);
 
 	std::vector<length> dasharray;
 
-	skip_whitespaces(iss);
+	p.skip_whitespaces();
 
-	while(!iss.eof()){
-		auto len_str = read_till_char_or_whitespace(iss, ',');
+	while(!p.empty()){
+		auto len_str = p.read_word_until(',');
 		auto l = length::parse(len_str);
 		dasharray.push_back(l);
 
-		skip_whitespaces_and_comma(iss);
+		p.skip_whitespaces_and_comma();
 	}
 
 	return style_value(std::move(dasharray));
@@ -71,25 +70,33 @@ style_value parse_stroke_dasharray(const std::string& str){
 }
 
 std::string styleable::style_value_to_string(style_property p, const style_value& v){
+	std::string s;
+	append_style_value(s, p, v);
+	return s;
+}
+
+void styleable::append_style_value(std::string& s, style_property p, const style_value& v){
 	if(!is_valid(v)){
-		return std::string();
+		return;
 	}
 
 	if(is_inherit(v)){
-		return inherit_word;
+		s += inherit_word;
+		return;
 	}else if(is_none(v)){
-		return none_word;
+		s += none_word;
+		return;
 	}else if(is_current_color(v)){
-		return current_color_word;
+		s += current_color_word;
+		return;
 	}
 
-	std::stringstream s;
 	switch(p){
 		default:
 			TRACE(<< "Unimplemented style property: " << styleable::property_to_string(p) << ", writing empty value." << std::endl)
 			break;
 		case style_property::color_interpolation_filters:
-			s << color_interpolation_filters_to_string(v);
+			s += color_interpolation_filters_to_string(v);
 			break;
 		case style_property::stroke_miterlimit:
 		case style_property::stop_opacity:
@@ -97,18 +104,18 @@ std::string styleable::style_value_to_string(style_property p, const style_value
 		case style_property::stroke_opacity:
 		case style_property::fill_opacity:
 			if(std::holds_alternative<real>(v)){
-				s << *std::get_if<real>(&v);
+				append_real(s, *std::get_if<real>(&v));
 			}
 			break;
 		case style_property::stop_color:
 		case style_property::fill:
 		case style_property::stroke:
-			s << paint_to_string(v);
+			append_paint(s, v);
 			break;
 		case style_property::stroke_dashoffset:
 		case style_property::stroke_width:
 			if(std::holds_alternative<length>(v)){
-				s << *std::get_if<length>(&v);
+				append_length(s, *std::get_if<length>(&v));
 			}
 			break;
 		case style_property::stroke_linecap:
@@ -118,13 +125,13 @@ std::string styleable::style_value_to_string(style_property p, const style_value
 						ASSERT(false)
 						break;
 					case stroke_line_cap::butt:
-						s << "butt";
+						s += "butt";
 						break;
 					case stroke_line_cap::round:
-						s << "round";
+						s += "round";
 						break;
 					case stroke_line_cap::square:
-						s << "square";
+						s += "square";
 						break;
 				}
 			}
@@ -136,13 +143,13 @@ std::string styleable::style_value_to_string(style_property p, const style_value
 						ASSERT(false)
 						break;
 					case stroke_line_join::miter:
-						s << "miter";
+						s += "miter";
 						break;
 					case stroke_line_join::round:
-						s << "round";
+						s += "round";
 						break;
 					case stroke_line_join::bevel:
-						s << "bevel";
+						s += "bevel";
 						break;
 				}
 			}
@@ -154,10 +161,10 @@ std::string styleable::style_value_to_string(style_property p, const style_value
 						ASSERT(false)
 						break;
 					case fill_rule::evenodd:
-						s << "evenodd";
+						s += "evenodd";
 						break;
 					case fill_rule::nonzero:
-						s << "nonzero";
+						s += "nonzero";
 						break;
 				}
 			}
@@ -165,61 +172,68 @@ std::string styleable::style_value_to_string(style_property p, const style_value
 		case style_property::mask:
 		case style_property::filter:
 			if(std::holds_alternative<std::string>(v)){
-				s << "url(" << *std::get_if<std::string>(&v) << ")";
+				s += "url(";
+				s += *std::get_if<std::string>(&v);
+				s += ')';
 			}
 			break;
 		case style_property::display:
-			s << display_to_string(v);
+			s += display_to_string(v);
 			break;
 		case style_property::enable_background:
-			s << enable_background_to_string(v);
+			s += enable_background_to_string(v);
 			break;
 		case style_property::visibility:
-			s << visibility_to_string(v);
+			s += visibility_to_string(v);
 			break;
 		case style_property::stroke_dasharray:
-			s << stroke_dasharray_to_string(v);
+			append_stroke_dasharray(s, v);
 			break;
 	}
-	return s.str();
 }
 
 std::string styleable::styles_to_string()const{
-	std::stringstream s;
-	
+	std::string s;
+	this->append_styles(s);
+	return s;
+}
+
+void styleable::append_styles(std::string& s)const{
 	bool isFirst = true;
 	
 	for(auto& st : this->styles){
 		if(isFirst){
 			isFirst = false;
 		}else{
-			s << "; ";
+			s += "; ";
 		}
 		
 		ASSERT(st.first != style_property::unknown)
 		
-		s << property_to_string(st.first) << ":";
+		s += property_to_string(st.first);
+		s += ':';
 		
-		s << style_value_to_string(st.first, st.second);
+		append_style_value(s, st.first, st.second);
 	}
-	return s.str();
 }
 
 std::string styleable::classes_to_string()const{
-	std::stringstream ss;
+	std::string s;
+	this->append_classes(s);
+	return s;
+}
 
+void styleable::append_classes(std::string& s)const{
 	for(auto i = this->classes.begin(); i != this->classes.end(); ++i){
 		if(i != this->classes.begin()){
-			ss << " ";
+			s += ' ';
 		}
-		ss << *i;
+		s += *i;
 	}
-
-	return ss.str();
 }
 
 // input parameter 'str' should have no leading or trailing white spaces
-style_value styleable::parse_style_property_value(style_property type, const std::string& str){
+style_value styleable::parse_style_property_value(style_property type, std::string_view str){
 	if(str == inherit_word){
 		return style_value(style_value_special::inherit);
 	}
@@ -232,8 +246,12 @@ style_value styleable::parse_style_property_value(style_property type, const std
 			return parse_color_interpolation(str);
 		case style_property::stroke_miterlimit:
 			{
-				std::stringstream iss(str);
-				real miterlimit = read_in_real(iss);
+				real miterlimit;
+				try{
+					miterlimit = string_parser(str).read_real();
+				}catch(std::invalid_argument&){
+					miterlimit = 0;
+				}
 				using std::max;
 				miterlimit = max(miterlimit, real(1)); // minimal value is 1
 				return style_value(miterlimit);
@@ -244,8 +262,12 @@ style_value styleable::parse_style_property_value(style_property type, const std
 		case style_property::stroke_opacity:
 		case style_property::fill_opacity:
 			{
-				std::istringstream iss(str);
-				real opacity = read_in_real(iss);
+				real opacity;
+				try{
+					opacity = string_parser(str).read_real();
+				}catch(std::invalid_argument&){
+					opacity = 0;
+				}
 				using std::min;
 				using std::max;
 				opacity = max(real(0), min(opacity, real(1))); // clamp to [0:1]
@@ -316,49 +338,35 @@ style_value styleable::parse_style_property_value(style_property type, const std
 	}
 }
 
-style_value svgdom::parse_url(const std::string& str){
-	std::string url = "url(";
+style_value svgdom::parse_url(std::string_view str){
+	std::string_view url = "url(";
 	
 	if(url != str.substr(0, url.length())){
 		return style_value(style_value_special::unknown);
 	}
 	
-	std::istringstream s(str);
-	skip_whitespaces(s);
-	
-	std::string tmpStr;
-	s >> std::setw(int(url.length())) >> tmpStr >> std::setw(0);
-	ASSERT(tmpStr == url)
+	string_parser p(str.substr(url.length()));
 
-	skip_whitespaces(s);
-	tmpStr = read_till_char_or_whitespace(s, ')');
+	p.skip_whitespaces();
+	auto iri = p.read_word_until(')');
 
-	skip_whitespaces(s);
-	if(s.get() == ')'){
-		return style_value(tmpStr);
+	p.skip_whitespaces();
+	if(!p.empty() && p.read_char() == ')'){
+		return style_value(std::string(iri));
 	}
 
-	return style_value(style_value_special::unknown);;
+	return style_value(style_value_special::unknown);
 }
 
-namespace{
-style_value parseStylePropertyValue(style_property type, std::istream& s){
-	skip_whitespaces(s);
-	std::string str = read_till_char(s, ';');
-	str = trim_tail(str);
-	return styleable::parse_style_property_value(type, str);
-}
-}
-
-decltype(styleable::styles) styleable::parse(const std::string& str){
-	std::istringstream s(str);
+decltype(styleable::styles) styleable::parse(std::string_view str){
+	string_parser p(str);
 	
-	skip_whitespaces(s);
+	p.skip_whitespaces();
 
 	decltype(styleable::styles) ret;
 	
-	while(!s.eof()){
-		std::string property = read_till_char_or_whitespace(s, ':');
+	while(!p.empty()){
+		auto property = p.read_word_until(':');
 		
 		style_property type = styleable::string_to_property(property);
 		
@@ -367,34 +375,45 @@ decltype(styleable::styles) styleable::parse(const std::string& str){
 			TRACE(<< "Unknown style property: " << property << std::endl)
 			TRACE(<< "str = " << str << std::endl)
 			TRACE(<< "ret.size() = " << ret.size() << std::endl)
-			skip_till_char_inclusive(s, ';');
+			p.skip_inclusive_until(';');
 			continue;
 		}
 		
-		skip_whitespaces(s);
+		p.skip_whitespaces();
 		
-		if(s.get() != ':'){
+		if(p.empty() || p.read_char() != ':'){
 			return ret; // expected colon
 		}
 		
-		style_value v = ::parseStylePropertyValue(type, s);
+		p.skip_whitespaces();
+		style_value v = styleable::parse_style_property_value(type, trim_tail(p.read_chars_until(';')));
 		
-		skip_whitespaces(s);
+		p.skip_whitespaces();
 		
-		if(!s.eof() && s.get() != ';'){
+		if(!p.empty() && p.read_char() != ';'){
 			return ret; // expected semicolon
 		}
 		
-		ret[type] = std::move(v);
+		ret.set(type, std::move(v));
 		
-		skip_whitespaces(s);
+		p.skip_whitespaces();
 	}
 	
 	return ret;
 }
 
 namespace{
-const std::set<style_property> nonInheritedStyleProperties = {
+constexpr uint64_t make_property_mask(std::initializer_list<style_property> properties){
+	uint64_t ret = 0;
+	for(auto p : properties){
+		ret |= uint64_t(1) << unsigned(p);
+	}
+	return ret;
+}
+
+static_assert(size_t(style_property::ENUM_SIZE) <= 64, "style properties do not fit into 64 bit mask");
+
+constexpr uint64_t non_inherited_properties_mask = make_property_mask({
 	style_property::alignment_baseline,
 	style_property::baseline_shift,
 	style_property::clip,
@@ -413,15 +432,15 @@ const std::set<style_property> nonInheritedStyleProperties = {
 	style_property::stop_opacity,
 	style_property::text_decoration,
 	style_property::unicode_bidi
-};
+});
 }
 
 bool styleable::is_inherited(style_property p) {
-	return nonInheritedStyleProperties.find(p) == nonInheritedStyleProperties.end();
+	return (non_inherited_properties_mask & (uint64_t(1) << unsigned(p))) == 0;
 }
 
 namespace{
-const std::map<std::string, style_property> string_to_property_map = {
+constexpr perfect_hash_entry<style_property> property_entries[] = {
 	{"alignment-baseline", style_property::alignment_baseline},
 	{"baseline-shift", style_property::baseline_shift},
 	{"clip", style_property::clip},
@@ -484,27 +503,220 @@ const std::map<std::string, style_property> string_to_property_map = {
 	{"word-spacing", style_property::word_spacing},
 	{"writing-mode", style_property::writing_mode}
 };
+
+constexpr auto string_to_property_map = make_perfect_hash_map(property_entries);
+
+constexpr auto property_to_string_array = make_key_array<size_t(style_property::ENUM_SIZE)>(property_entries);
 }
 
-namespace{
-auto property_to_string_map = utki::flip_map(string_to_property_map);
+style_property styleable::string_to_property(std::string_view str){
+	return string_to_property_map.get(str, style_property::unknown);
 }
 
-style_property styleable::string_to_property(std::string str){
-	auto i = string_to_property_map.find(str);
-	if(i != string_to_property_map.end()){
-		return i->second;
+std::string styleable::property_to_string(style_property p){
+	auto i = size_t(p);
+	if(i >= property_to_string_array.size()){
+		return std::string();
 	}
-	
-	return style_property::unknown;
+	return std::string(property_to_string_array[i]);
 }
 
-std::string styleable::property_to_string(style_property p){
-	auto i = property_to_string_map.find(p);
-	if(i != property_to_string_map.end()){
-		return i->second;
+style_map::style_map(const style_map& m){
+	this->operator=(m);
+}
+
+style_map& style_map::operator=(const style_map& m){
+	if(this == &m){
+		return *this;
+	}
+	auto b = m.get_buffer();
+	this->lazy.reset();
+	this->release();
+	if(!b || b->size == 0){
+		return *this;
+	}
+	if(b->shareable){
+		// only the reference counter of the memory block is changed, the original map is left intact
+		m.data->refs.add_ref();
+		this->data = m.data;
+	}else{
+		this->data = copy(*b, b->size);
+	}
+	return *this;
+}
+
+style_map::style_map(style_map&& m)noexcept :
+		data(m.data),
+		lazy(std::move(m.lazy))
+{
+	m.data = nullptr;
+}
+
+style_map& style_map::operator=(style_map&& m)noexcept{
+	if(this == &m){
+		return *this;
+	}
+	this->release();
+	this->data = m.data;
+	m.data = nullptr;
+	this->lazy = std::move(m.lazy);
+	return *this;
+}
+
+void style_map::release()noexcept{
+	if(!this->data){
+		return;
+	}
+	if(this->data->refs.release()){
+		std::destroy_n(this->data->values(), this->data->size);
+		this->data->~buffer();
+		::operator delete(this->data);
+	}
+	this->data = nullptr;
+}
+
+style_map::buffer* style_map::allocate(size_t capacity){
+	auto b = new(::operator new(sizeof(buffer) + capacity * sizeof(value_type))) buffer;
+	b->size = 0;
+	b->capacity = uint32_t(capacity);
+	b->shareable = true;
+	return b;
+}
+
+style_map::buffer* style_map::copy(const buffer& b, size_t capacity){
+	ASSERT(b.size <= capacity)
+	auto ret = allocate(capacity);
+	try{
+		std::uninitialized_copy_n(b.values(), b.size, ret->values());
+	}catch(...){
+		ret->~buffer();
+		::operator delete(ret);
+		throw;
+	}
+	ret->size = b.size;
+	return ret;
+}
+
+void style_map::reallocate(size_t capacity){
+	auto old = this->data;
+	if(!old){
+		this->data = allocate(capacity);
+		return;
+	}
+
+	buffer* b;
+	// values of shared memory block are copied, own values are moved
+	if(!old->refs.is_shared()){
+		ASSERT(old->size <= capacity)
+		b = allocate(capacity);
+		std::uninitialized_move_n(old->values(), old->size, b->values());
+		b->size = old->size;
+	}else{
+		b = copy(*old, capacity);
+	}
+
+	this->release();
+	this->data = b;
+}
+
+style_map::buffer* style_map::detach(){
+	this->ensure_parsed();
+	auto b = this->data;
+	if(b && b->refs.is_shared()){
+		this->reallocate(b->size);
+	}
+	return this->data;
+}
+
+style_map::buffer* style_map::detach_for_references(){
+	auto b = this->detach();
+	if(b){
+		b->shareable = false;
+	}
+	return b;
+}
+
+size_t style_map::lower_bound_index(style_property p)const{
+	return size_t(this->lower_bound(p) - this->begin());
+}
+
+style_value& style_map::get_or_insert(style_property p){
+	auto index = this->lower_bound_index(p);
+	auto b = this->detach();
+	if(b && index != b->size && b->values()[index].first == p){
+		return b->values()[index].second;
+	}
+
+	if(!b || b->size == b->capacity){
+		// the number of style properties is small, so grow the memory block linearly
+		this->reallocate(b ? b->size + 4 : 4);
+		b = this->data;
+	}
+
+	auto values = b->values();
+	auto end = values + b->size;
+	auto pos = values + index;
+	if(pos == end){
+		new(end) value_type(p, style_value());
+	}else{
+		new(end) value_type(std::move(*(end - 1)));
+		std::move_backward(pos, end - 1, end);
+		*pos = value_type(p, style_value());
 	}
-	return std::string();
+	++b->size;
+	return pos->second;
+}
+
+style_value& style_map::operator[](style_property p){
+	auto& ret = this->get_or_insert(p);
+	this->data->shareable = false;
+	return ret;
+}
+
+void style_map::set(style_property p, style_value v){
+	this->get_or_insert(p) = std::move(v);
+}
+
+style_map::value_type* style_map::remove(size_t index){
+	auto b = this->data;
+	ASSERT(b && index < b->size)
+	auto values = b->values();
+	auto pos = values + index;
+	std::move(pos + 1, values + b->size, pos);
+	--b->size;
+	std::destroy_at(values + b->size);
+	return pos;
+}
+
+style_map::iterator style_map::erase(const_iterator i){
+	// the iterator may point to shared values, so convert it to index before detaching
+	auto index = size_t(i - std::as_const(*this).begin());
+	this->detach_for_references();
+	return this->remove(index);
+}
+
+size_t style_map::erase(style_property p){
+	auto index = this->lower_bound_index(p);
+	if(index == this->size() || std::as_const(*this).begin()[index].first != p){
+		return 0;
+	}
+	this->detach();
+	this->remove(index);
+	return 1;
+}
+
+void style_map::ensure_parsed()const{
+	this->lazy.parse_once([this](std::string_view str){
+		auto m = styleable::parse(str);
+		ASSERT(!this->data)
+		this->data = m.data;
+		m.data = nullptr;
+	});
+}
+
+void style_map::set_lazy(std::string str){
+	this->release();
+	this->lazy.set(std::move(str));
 }
 
 const style_value* styleable::get_style_property(style_property p)const{
@@ -553,7 +765,7 @@ style_value svgdom::make_style_value(const r4::vector3<real>& rgb){
 }
 
 namespace{
-const std::map<std::string, uint32_t> color_name_to_color_map = {
+constexpr perfect_hash_entry<uint32_t> color_entries[] = {
 	{"aliceblue", 0xfff8f0},
 	{"antiquewhite", 0xd7ebfa},
 	{"aqua", 0xffff00},
@@ -702,14 +914,38 @@ const std::map<std::string, uint32_t> color_name_to_color_map = {
 	{"yellow", 0xffff},
 	{"yellowgreen", 0x32cd9a}
 };
+
+constexpr auto color_name_to_color_map = make_perfect_hash_map(color_entries);
+
+constexpr size_t num_colors = sizeof(color_entries) / sizeof(color_entries[0]);
+
+constexpr bool color_entry_less(const perfect_hash_entry<uint32_t>& a, const perfect_hash_entry<uint32_t>& b){
+	if(a.value != b.value){
+		return a.value < b.value;
+	}
+	return a.key < b.key;
 }
 
-namespace{
-const auto color_to_color_name_map = utki::flip_map(color_name_to_color_map);
+// color entries sorted by color value for binary search,
+// in case several names have the same color the alphabetically first name goes first
+constexpr std::array<perfect_hash_entry<uint32_t>, num_colors> make_color_to_color_name_array(){
+	std::array<perfect_hash_entry<uint32_t>, num_colors> ret{};
+	for(size_t i = 0; i != num_colors; ++i){
+		// insertion sort
+		size_t j = i;
+		for(; j != 0 && color_entry_less(color_entries[i], ret[j - 1]); --j){
+			ret[j] = ret[j - 1];
+		}
+		ret[j] = color_entries[i];
+	}
+	return ret;
+}
+
+constexpr auto color_to_color_name_array = make_color_to_color_name_array();
 }
 
 namespace{
-std::map<std::string, display> string_to_display_map = {
+constexpr perfect_hash_entry<display> display_entries[] = {
 	{"inline", svgdom::display::inline_},
 	{"block", svgdom::display::block},
 	{"list-item", svgdom::display::list_item},
@@ -726,77 +962,67 @@ std::map<std::string, display> string_to_display_map = {
 	{"table-column", svgdom::display::table_column},
 	{"table-cell", svgdom::display::table_cell},
 	{"table-caption", svgdom::display::table_caption},
-	{none_word, svgdom::display::none}
+	{"none", svgdom::display::none}
 };
-}
 
-namespace{
-auto display_to_string_map = utki::flip_map(string_to_display_map);
+constexpr auto string_to_display_map = make_perfect_hash_map(display_entries);
+
+constexpr auto display_to_string_array = make_key_array<size_t(svgdom::display::none) + 1>(display_entries);
 }
 
-style_value svgdom::parse_display(const std::string& str){
+style_value svgdom::parse_display(std::string_view str){
 	// NOTE: "inherit" is already checked on upper level.
 
-	auto i = string_to_display_map.find(str);
-	if(i == string_to_display_map.end()){
-		return style_value(svgdom::display::inline_); // default value
-	}else{
-		return style_value(i->second);
-	}
+	return style_value(string_to_display_map.get(str, svgdom::display::inline_)); // inline is the default value
 }
 
 std::string svgdom::display_to_string(const style_value& v){
-	const auto& default_value = display_to_string_map[svgdom::display::inline_];
+	auto default_value = display_to_string_array[size_t(svgdom::display::inline_)];
 
 	if(!std::holds_alternative<svgdom::display>(v)){
-		return default_value;
+		return std::string(default_value);
 	}
 
-	auto i = display_to_string_map.find(*std::get_if<svgdom::display>(&v));
-	if(i == display_to_string_map.end()){
-		return default_value;
+	auto i = size_t(*std::get_if<svgdom::display>(&v));
+	if(i >= display_to_string_array.size()){
+		return std::string(default_value);
 	}
-	return i->second;
+	return std::string(display_to_string_array[i]);
 }
 
 namespace{
-std::map<std::string, visibility> string_to_visibility_map = {
+constexpr perfect_hash_entry<visibility> visibility_entries[] = {
 	{"visible", visibility::visible},
 	{"hidden", visibility::hidden},
 	{"collapse", visibility::collapse}
 };
-}
 
-namespace{
-auto visibility_to_string_map = utki::flip_map(string_to_visibility_map);
+constexpr auto string_to_visibility_map = make_perfect_hash_map(visibility_entries);
+
+constexpr auto visibility_to_string_array = make_key_array<size_t(svgdom::visibility::collapse) + 1>(visibility_entries);
 }
 
-style_value svgdom::parse_visibility(const std::string& str){
+style_value svgdom::parse_visibility(std::string_view str){
 	// NOTE: "inherit" is already checked on upper level.
 	
-	auto i = string_to_visibility_map.find(str);
-	if(i == string_to_visibility_map.end()){
-		return style_value(svgdom::visibility::visible); // default value
-	}else{
-		return style_value(i->second);
-	}
+	return style_value(string_to_visibility_map.get(str, svgdom::visibility::visible)); // visible is the default value
 }
 
 std::string svgdom::visibility_to_string(const style_value& v){
-	const auto& default_value = visibility_to_string_map[svgdom::visibility::visible];
+	auto default_value = visibility_to_string_array[size_t(svgdom::visibility::visible)];
 
 	if(!std::holds_alternative<svgdom::visibility>(v)){
-		return default_value;
+		return std::string(default_value);
 	}
 
-	auto i = visibility_to_string_map.find(*std::get_if<svgdom::visibility>(&v));
-	if(i == visibility_to_string_map.end()){
-		return default_value;
+	auto i = size_t(*std::get_if<svgdom::visibility>(&v));
+	if(i >= visibility_to_string_array.size()){
+		return std::string(default_value);
 	}
-	return i->second;
+	return std::string(visibility_to_string_array[i]);
 }
 
-style_value svgdom::parse_color_interpolation(const std::string& str){
+style_value svgdom::parse_color_interpolation(std::string_view str){
 	color_interpolation v;
 	if(str == "auto"){
 		v = color_interpolation::auto_;
@@ -836,48 +1062,37 @@ std::string svgdom::color_interpolation_filters_to_string(const style_value& v){
 }
 
 namespace{
-enable_background_property parseEnableBackgroundNewRect(const std::string& str){
+enable_background_property parseEnableBackgroundNewRect(std::string_view str){
 	enable_background_property ret;
 	
-	std::istringstream s(str);
-	skip_till_char_inclusive(s, ' '); // skip 'new'
+	string_parser p(str);
+	p.skip_inclusive_until(' '); // skip 'new'
 
-	skip_whitespaces(s);
+	p.skip_whitespaces();
 	
-	if(s.eof()){
+	if(p.empty()){
 		ret.rect.d.x() = -1; // indicate that rectangle is not specified
 		return ret;
 	}
 	
-	ret.rect.p.x() = read_in_real(s);
-	if(s.fail()){
+	try{
+		ret.rect.p.x() = p.read_real();
+		ret.rect.p.y() = p.read_real();
+		ret.rect.d.x() = p.read_real();
+		ret.rect.d.y() = p.read_real();
+	}catch(std::invalid_argument&){
 		throw malformed_svg_error("malformed 'enable-background NEW' string");
 	}
 	
-	ret.rect.p.y() = read_in_real(s);
-	if(s.fail()){
-		throw malformed_svg_error("malformed 'enable-background NEW' string");
-	}
-	
-	ret.rect.d.x() = read_in_real(s);
-	if(s.fail()){
-		throw malformed_svg_error("malformed enable-background NEW string");
-	}
-	
-	ret.rect.d.y() = read_in_real(s);
-	if(s.fail()){
-		throw malformed_svg_error("malformed enable-background NEW string");
-	}
-	
 	return ret;
 }
 }
 
-style_value svgdom::parse_enable_background(const std::string& str){
+style_value svgdom::parse_enable_background(std::string_view str){
 	enable_background_property ebp;
 
-	std::string newStr = "new";
-	if(str.substr(0, newStr.length()) == "new"){
+	std::string_view newStr = "new";
+	if(str.substr(0, newStr.length()) == newStr){
 		try{
 			ebp = parseEnableBackgroundNewRect(str);
 			ebp.value = svgdom::enable_background::new_;
@@ -906,18 +1121,16 @@ std::string svgdom::enable_background_to_string(const style_value& v){
 			return default_value;
 		case svgdom::enable_background::new_:
 			{
-				std::stringstream ss;
-				
-				ss << "new";
+				std::string s = "new";
 				
 				if(ebp.is_rect_specified()){
-					ss << " " << ebp.rect.p.x();
-					ss << " " << ebp.rect.p.y();
-					ss << " " << ebp.rect.d.x();
-					ss << " " << ebp.rect.d.y();
+					for(auto c : {ebp.rect.p.x(), ebp.rect.p.y(), ebp.rect.d.x(), ebp.rect.d.y()}){
+						s += ' ';
+						append_real(s, c);
+					}
 				}
 				
-				return ss.str();
+				return s;
 			}
 	}
 }
@@ -973,8 +1186,27 @@ uint32_t hslToRgb(real h, real s, real l){
 }
 }
 
+namespace{
+// reads unsigned integer after optional white spaces, like std::istream does
+std::optional<uint32_t> read_uint(string_parser& p){
+	p.skip_whitespaces();
+
+	auto v = p.get_view();
+	size_t i = 0;
+	uint32_t ret = 0;
+	for(; i != v.size() && '0' <= v[i] && v[i] <= '9'; ++i){
+		ret = ret * 10 + uint32_t(v[i] - '0');
+	}
+	if(i == 0){
+		return std::nullopt;
+	}
+	p = string_parser(v.substr(i));
+	return ret;
+}
+}
+
 // 'str' should have no leading and/or trailing white spaces.
-style_value svgdom::parse_paint(const std::string& str){
+style_value svgdom::parse_paint(std::string_view str){
 	// TRACE(<< "parse_paint(): str = " << str << std::endl)
 	if(str.empty()){
 		return style_value(style_value_special::none);
@@ -1001,12 +1233,12 @@ style_value svgdom::parse_paint(const std::string& str){
 	// check if #-notation
 	if(str[0] == '#'){
 		// TRACE(<< "#-notation" << std::endl)
-		std::istringstream s(str.substr(1, 6));
+		auto hex = str.substr(1, 6);
 		
 		std::array<uint8_t, 6> d;
 		unsigned numDigits = 0;
-		for(auto i = d.begin(); i != d.end(); ++i, ++numDigits){
-			char c = s.get();
+		for(auto i = d.begin(); i != d.end() && numDigits != hex.size(); ++i, ++numDigits){
+			char c = hex[numDigits];
 			if('0' <= c && c <= '9'){
 				(*i) = c - '0';
 			}else if('a' <= c && c <= 'f'){
@@ -1044,27 +1276,19 @@ style_value svgdom::parse_paint(const std::string& str){
 	
 	// check if rgb() or RGB() notation
 	{
-		const std::string rgb = "rgb(";
+		std::string_view rgb = "rgb(";
 		if(rgb == str.substr(0, rgb.length())){
-			std::istringstream s(str);
-			
-			std::string tmpStr;
+			string_parser p(str.substr(rgb.length()));
 			
-			s >> std::setw(int(rgb.length())) >> tmpStr >> std::setw(0);
-			ASSERT(tmpStr == rgb)
+			auto r = read_uint(p);
+			p.skip_whitespaces_and_comma();
+			auto g = read_uint(p);
+			p.skip_whitespaces_and_comma();
+			auto b = read_uint(p);
+			p.skip_whitespaces();
 			
-			uint32_t r, g, b;
-			
-			skip_whitespaces(s);
-			s >> r;
-			skip_whitespaces_and_comma(s);
-			s >> g;
-			skip_whitespaces_and_comma(s);
-			s >> b;
-			skip_whitespaces(s);
-			
-			if(s.get() == ')'){
-				auto color = r | (g << 8) | (b << 16);
+			if(r && g && b && !p.empty() && p.read_char() == ')'){
+				auto color = *r | (*g << 8) | (*b << 16);
 				return style_value(color);
 			}
 			return style_value(style_value_special::none);
@@ -1074,33 +1298,25 @@ style_value svgdom::parse_paint(const std::string& str){
 	// check if hsl() notation
 	{
 		// TRACE(<< "hsl()-notation" << std::endl)
-		const std::string hsl = "hsl(";
+		std::string_view hsl = "hsl(";
 		if(hsl == str.substr(0, hsl.length())){
-			std::istringstream ss(str);
-			
-			std::string tmpStr;
-			
-			ss >> std::setw(int(hsl.length())) >> tmpStr >> std::setw(0);
-			ASSERT(tmpStr == hsl)
+			string_parser p(str.substr(hsl.length()));
 			
-			uint32_t h, s, l;
-			
-			skip_whitespaces(ss);
-			ss >> h;
-			skip_whitespaces_and_comma(ss);
-			ss >> s;
-			if(ss.get() != '%'){
+			auto h = read_uint(p);
+			p.skip_whitespaces_and_comma();
+			auto s = read_uint(p);
+			if(!s || p.empty() || p.read_char() != '%'){
 				return style_value(style_value_special::none);
 			}
-			skip_whitespaces_and_comma(ss);
-			ss >> l;
-			if(ss.get() != '%'){
+			p.skip_whitespaces_and_comma();
+			auto l = read_uint(p);
+			if(!l || p.empty() || p.read_char() != '%'){
 				return style_value(style_value_special::none);
 			}
-			skip_whitespaces(ss);
+			p.skip_whitespaces();
 			
-			if(ss.get() == ')'){
-				auto color = hslToRgb(real(h), real(s) / real(100), real(l) / real(100));
+			if(h && !p.empty() && p.read_char() == ')'){
+				auto color = hslToRgb(real(*h), real(*s) / real(100), real(*l) / real(100));
 				return style_value(color);
 			}
 			return style_value(style_value_special::none);
@@ -1109,14 +1325,12 @@ style_value svgdom::parse_paint(const std::string& str){
 	
 	// check if color name
 	{
-		std::istringstream s(str);
-		std::string name;
-		s >> name;
+		auto name = string_parser(str).read_word();
 		
-		auto i = color_name_to_color_map.find(name);
-		if(i != color_name_to_color_map.end()){
-			ASSERT(i->first == name)
-			return style_value(i->second);
+		constexpr uint32_t invalid_color = ~uint32_t(0);
+		auto c = color_name_to_color_map.get(name, invalid_color);
+		if(c != invalid_color){
+			return style_value(c);
 		}
 	}
 	
@@ -1124,43 +1338,54 @@ style_value svgdom::parse_paint(const std::string& str){
 }
 
 std::string svgdom::paint_to_string(const style_value& v){
+	std::string s;
+	append_paint(s, v);
+	return s;
+}
+
+void svgdom::append_paint(std::string& s, const style_value& v){
 	if(std::holds_alternative<style_value_special>(v)){ // special value
 		switch(*std::get_if<style_value_special>(&v)){
 			case style_value_special::none:
-				return none_word;
-			case style_value_special::inherit: // TODO: isn't it already handled in styleable::style_value_to_string()?
-				return inherit_word;
+				s += none_word;
+				break;
+			case style_value_special::inherit: // TODO: isn't it already handled in styleable::append_style_value()?
+				s += inherit_word;
+				break;
 			case style_value_special::current_color:
-				return current_color_word;
+				s += current_color_word;
+				break;
 			default:
-				return std::string();
+				break;
 		}
 	}else if(std::holds_alternative<std::string>(v)){ // URL
-		std::stringstream ss;
-		ss << "url(" << *std::get_if<std::string>(&v) << ")";
-		return ss.str();
+		s += "url(";
+		s += *std::get_if<std::string>(&v);
+		s += ')';
 	}else if(std::holds_alternative<uint32_t>(v)){
-		auto i = color_to_color_name_map.find(*std::get_if<uint32_t>(&v));
-		if(i != color_to_color_name_map.end()){
+		auto color = *std::get_if<uint32_t>(&v);
+		auto i = std::lower_bound(
+				color_to_color_name_array.begin(),
+				color_to_color_name_array.end(),
+				color,
+				[](const perfect_hash_entry<uint32_t>& e, uint32_t c){
+					return e.value < c;
+				}
+			);
+		if(i != color_to_color_name_array.end() && i->value == color){
 			// color name
 
-			return i->second;
+			s += i->key;
 		}else{
 			// #-notation
 
-			std::stringstream s;
-			s << std::hex;
-			s << "#";
-			s << ((*std::get_if<uint32_t>(&v) >> 4) & 0xf);
-			s << ((*std::get_if<uint32_t>(&v)) & 0xf);
-			s << ((*std::get_if<uint32_t>(&v) >> 12) & 0xf);
-			s << ((*std::get_if<uint32_t>(&v) >> 8) & 0xf);
-			s << ((*std::get_if<uint32_t>(&v) >> 20) & 0xf);
-			s << ((*std::get_if<uint32_t>(&v) >> 16) & 0xf);
-			return s.str();
+			const char* hex_digits = "0123456789abcdef";
+			s += '#';
+			for(unsigned shift : {4, 0, 12, 8, 20, 16}){
+				s += hex_digits[(color >> shift) & 0xf];
+			}
 		}
 	}
-	return std::string();
 }
 
 std::string svgdom::get_local_id_from_iri(const style_value& v){
@@ -2,7 +2,11 @@
 
 #include <map>
 #include <vector>
+#include <memory>
+#include <iterator>
+#include <algorithm>
 #include <variant>
+#include <string_view>
 
 #include <cssdom/dom.hpp>
 
@@ -11,6 +15,8 @@
 
 #include "../config.hpp"
 #include "../length.hpp"
+#include "lazy_attribute.hpp"
+#include "ref_counter.hpp"
 
 namespace svgdom{
 
@@ -198,23 +204,31 @@ inline bool is_current_color(const style_value& v){
  */
 std::string get_local_id_from_iri(const style_value& v);
 
-style_value parse_paint(const std::string& str);
+style_value parse_paint(std::string_view str);
 std::string paint_to_string(const style_value& v);
 
-style_value parse_color_interpolation(const std::string& str);
+/**
+ * @brief Append paint to string.
+ * Same as paint_to_string(), but appends to the given string instead of making a new one.
+ * @param s - string to append the paint to.
+ * @param v - paint value.
+ */
+void append_paint(std::string& s, const style_value& v);
+
+style_value parse_color_interpolation(std::string_view str);
 	
-style_value parse_display(const std::string& str);
+style_value parse_display(std::string_view str);
 std::string display_to_string(const style_value& v);
 
-style_value parse_visibility(const std::string& str);
+style_value parse_visibility(std::string_view str);
 std::string visibility_to_string(const style_value& v);
 	
-style_value parse_enable_background(const std::string& str);
+style_value parse_enable_background(std::string_view str);
 std::string enable_background_to_string(const style_value& v);
 	
 std::string color_interpolation_filters_to_string(const style_value& v);
 
-style_value parse_url(const std::string& str);
+style_value parse_url(std::string_view str);
 
 /**
  * @brief get color as RGB.
@@ -239,13 +253,212 @@ style_value make_style_value(uint8_t r, uint8_t g, uint8_t b);
  */
 style_value make_style_value(const r4::vector3<real>& rgb);
 
+/**
+ * @brief Map of style property values.
+ * The values are kept sorted by style property in a single memory block together with their number.
+ * Elements usually have just a few style properties set, so this is more compact and cache friendly
+ * than std::map, the map object itself is just a pointer to that block plus the lazy parsing state,
+ * and empty map allocates nothing.
+ * Provides a subset of std::map interface. Note, that unlike with std::map, adding or
+ * removing properties invalidates iterators and pointers to values.
+ * Copies share the memory block with the original until either of them is modified, see also unshare().
+ * Modification of a map which shares its memory block invalidates iterators and pointers to values
+ * of that map. Once non-const iterators or references to values are obtained from a map, its memory block
+ * is not shared with subsequent copies anymore, since the values can be changed through those references.
+ * Use set() and erase() to modify the map without that. The memory block is reference counted, so copying
+ * does not change the original map in any other way and several threads can copy the same map simultaneously.
+ */
+class style_map{
+public:
+	typedef std::pair<style_property, style_value> value_type;
+
+	typedef value_type* iterator;
+	typedef const value_type* const_iterator;
+private:
+	// Header of the memory block, followed by the values.
+	struct alignas(alignof(value_type)) buffer{
+		ref_counter refs;
+		uint32_t size;
+		uint32_t capacity;
+
+		// false if non-const references to the values were given out
+		bool shareable;
+
+		value_type* values()noexcept{
+			return reinterpret_cast<value_type*>(this + 1);
+		}
+
+		const value_type* values()const noexcept{
+			return reinterpret_cast<const value_type*>(this + 1);
+		}
+	};
+
+	// mutable because lazily parsed style is filled in on first access
+	mutable buffer* data = nullptr;
+
+	lazy_attribute lazy;
+
+	void ensure_parsed()const;
+
+	const buffer* get_buffer()const{
+		this->ensure_parsed();
+		return this->data;
+	}
+
+	// drop reference to the memory block
+	void release()noexcept;
+
+	static buffer* allocate(size_t capacity);
+
+	// make a new memory block of given capacity holding copies of the values
+	static buffer* copy(const buffer& b, size_t capacity);
+
+	// copy or move values to a new memory block of given capacity
+	void reallocate(size_t capacity);
+
+	// make sure the memory block is not shared, returns nullptr if there are no values
+	buffer* detach();
+
+	// detach and do not share the memory block with copies made afterwards
+	buffer* detach_for_references();
+
+	// index of the first value not less than given property
+	size_t lower_bound_index(style_property p)const;
+
+	// detach and find the value of given property, insert default value if not found
+	style_value& get_or_insert(style_property p);
+
+	// remove value from detached memory block, returns pointer to the next value
+	value_type* remove(size_t index);
+public:
+	style_map() = default;
+
+	style_map(const style_map& m);
+	style_map& operator=(const style_map& m);
+
+	style_map(style_map&& m)noexcept;
+	style_map& operator=(style_map&& m)noexcept;
+
+	~style_map()noexcept{
+		this->release();
+	}
+
+	iterator begin(){
+		auto b = this->detach_for_references();
+		return b ? b->values() : nullptr;
+	}
+
+	iterator end(){
+		auto b = this->detach_for_references();
+		return b ? b->values() + b->size : nullptr;
+	}
+
+	const_iterator begin()const{
+		auto b = this->get_buffer();
+		return b ? b->values() : nullptr;
+	}
+
+	const_iterator end()const{
+		auto b = this->get_buffer();
+		return b ? b->values() + b->size : nullptr;
+	}
+
+	size_t size()const{
+		auto b = this->get_buffer();
+		return b ? b->size : 0;
+	}
+
+	bool empty()const{
+		return this->size() == 0;
+	}
+
+	void clear()noexcept{
+		this->lazy.reset();
+		this->release();
+	}
+
+	iterator lower_bound(style_property p){
+		auto b = this->begin();
+		return std::lower_bound(
+				b,
+				this->end(),
+				p,
+				[](const value_type& v, style_property p){
+					return v.first < p;
+				}
+			);
+	}
+
+	const_iterator lower_bound(style_property p)const{
+		return std::lower_bound(
+				this->begin(),
+				this->end(),
+				p,
+				[](const value_type& v, style_property p){
+					return v.first < p;
+				}
+			);
+	}
+
+	iterator find(style_property p){
+		auto i = this->lower_bound(p);
+		auto e = this->end();
+		if(i == e || i->first != p){
+			return e;
+		}
+		return i;
+	}
+
+	const_iterator find(style_property p)const{
+		auto i = this->lower_bound(p);
+		auto e = this->end();
+		if(i == e || i->first != p){
+			return e;
+		}
+		return i;
+	}
+
+	size_t count(style_property p)const{
+		return this->find(p) == this->end() ? 0 : 1;
+	}
+
+	style_value& operator[](style_property p);
+
+	iterator erase(const_iterator i);
+
+	size_t erase(style_property p);
+
+	/**
+	 * @brief Set property value.
+	 * Unlike operator[], does not give out a reference to the value, so the map
+	 * keeps sharing its memory block with copies, see style_map description.
+	 * @param p - property to set.
+	 * @param v - value of the property.
+	 */
+	void set(style_property p, style_value v);
+
+	/**
+	 * @brief Make own copy of the values if the memory block is shared with other copies.
+	 */
+	void unshare(){
+		this->detach();
+	}
+
+	/**
+	 * @brief Set style string to be parsed on first access.
+	 * Replaces current values.
+	 * @param str - style string, i.e. value of 'style' attribute.
+	 */
+	void set_lazy(std::string str);
+};
+
 
 /**
  * @brief An element which has 'style' attribute or can be styled.
  */
 struct styleable : public cssdom::styleable{
-	std::map<style_property, style_value> styles;
-	std::map<style_property, style_value> presentation_attributes;
+	style_map styles;
+	style_map presentation_attributes;
 
 	std::vector<std::string> classes;
 
@@ -261,18 +474,39 @@ struct styleable : public cssdom::styleable{
 
 	std::string classes_to_string()const;
 
+	/**
+	 * @brief Append space separated classes to string.
+	 * @param s - string to append the classes to.
+	 */
+	void append_classes(std::string& s)const;
+
 	std::string styles_to_string()const;
 
+	/**
+	 * @brief Append styles to string.
+	 * Appends the styles in the format of 'style' attribute value.
+	 * @param s - string to append the styles to.
+	 */
+	void append_styles(std::string& s)const;
+
 	static std::string style_value_to_string(style_property p, const style_value& v);
 
-	static decltype(styles) parse(const std::string& str);
+	/**
+	 * @brief Append style value to string.
+	 * @param s - string to append the value to.
+	 * @param p - style property the value belongs to.
+	 * @param v - value to append.
+	 */
+	static void append_style_value(std::string& s, style_property p, const style_value& v);
+
+	static decltype(styles) parse(std::string_view str);
 
-	static style_value parse_style_property_value(style_property type, const std::string& str);
+	static style_value parse_style_property_value(style_property type, std::string_view str);
 
 	static bool is_inherited(style_property p);
 
 	static std::string property_to_string(style_property p);
-	static style_property string_to_property(std::string str);
+	static style_property string_to_property(std::string_view str);
 };
 
 }
@@ -22,6 +22,10 @@ class text_element :
 public:
 	//TODO: attributes lengthAdjust, textLength are not implemented yet.
 	
+	text_element(){
+		this->type_tag = element_type::text;
+	}
+
 	void accept(visitor& v) override;
 	void accept(const_visitor& v) const override;
 
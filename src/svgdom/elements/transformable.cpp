@@ -1,14 +1,60 @@
 #include "transformable.hpp"
 
+#include <sstream>
+#include <initializer_list>
+
 #include <utki/debug.hpp>
 
 #include "../util.hxx"
 
 using namespace svgdom;
 
+transformable::transformation_list::transformation_list(const transformation_list& l){
+	this->operator=(l);
+}
+
+transformable::transformation_list& transformable::transformation_list::operator=(const transformation_list& l){
+	if(this == &l){
+		return *this;
+	}
+	l.ensure_parsed();
+	this->lazy.reset();
+	this->values = l.values;
+	return *this;
+}
+
+void transformable::transformation_list::ensure_parsed()const{
+	this->lazy.parse_once([this](std::string_view str){
+		this->values = std::move(transformable::parse(str).values);
+	});
+}
+
+void transformable::transformation_list::set_lazy(std::string str){
+	this->values.clear();
+	this->lazy.set(std::move(str));
+}
+
 
 std::string transformable::transformations_to_string() const {
-	std::stringstream s;
+	std::string s;
+	this->append_transformations(s);
+	return s;
+}
+
+void transformable::append_transformations(std::string& s)const{
+	// appends comma separated list of numbers followed by closing parenthesis
+	auto append_args = [&s](std::initializer_list<real> args){
+		bool first = true;
+		for(auto a : args){
+			if(first){
+				first = false;
+			}else{
+				s += ',';
+			}
+			append_real(s, a);
+		}
+		s += ')';
+	};
 
 	bool isFirst = true;
 
@@ -16,7 +62,7 @@ std::string transformable::transformations_to_string() const {
 		if(isFirst){
 			isFirst = false;
 		}else{
-			s << " ";
+			s += ' ';
 		}
 
 		switch(t.type_){
@@ -24,53 +70,55 @@ std::string transformable::transformations_to_string() const {
 				ASSERT(false)
 				break;
 			case transformation::type::matrix:
-				s << "matrix(" << t.a << "," << t.b << "," << t.c << "," << t.d << "," << t.e << "," << t.f << ")";
+				s += "matrix(";
+				append_args({t.a, t.b, t.c, t.d, t.e, t.f});
 				break;
 			case transformation::type::translate:
-				s << "translate(" << t.x;
+				s += "translate(";
 				if(t.y != 0){
-					s << "," << t.y;
+					append_args({t.x, t.y});
+				}else{
+					append_args({t.x});
 				}
-				s << ")";
 				break;
 			case transformation::type::scale:
-				s << "scale(" << t.x;
+				s += "scale(";
 				if(t.x != t.y){
-					s << "," << t.y;
+					append_args({t.x, t.y});
+				}else{
+					append_args({t.x});
 				}
-				s << ")";
 				break;
 			case transformation::type::rotate:
-				s << "rotate(" << t.angle;
+				s += "rotate(";
 				if(t.x != 0 || t.y != 0){
-					s << "," << t.x << "," << t.y;
+					append_args({t.angle, t.x, t.y});
+				}else{
+					append_args({t.angle});
 				}
-				s << ")";
 				break;
 			case transformation::type::skewx:
-				s << "skewX(" << t.angle << ")";
+				s += "skewX(";
+				append_args({t.angle});
 				break;
 			case transformation::type::skewy:
-				s << "skewY(" << t.angle << ")";
+				s += "skewY(";
+				append_args({t.angle});
 				break;
 		}
 	}
-
-	return s.str();
 }
 
 
-decltype(transformable::transformations) transformable::parse(const std::string& str){
-	std::istringstream s(str);
-
-	s >> std::skipws;
+decltype(transformable::transformations) transformable::parse(std::string_view str){
+	string_parser p(str);
 
-	skip_whitespaces(s);
+	p.skip_whitespaces();
 
 	decltype(transformable::transformations) ret;
 
-	while(!s.eof()){
-		std::string transform = read_till_char_or_whitespace(s, '(');
+	while(!p.empty()){
+		auto transform = p.read_word_until('(');
 
 //		TRACE(<< "transform = " << transform << std::endl)
 
@@ -92,114 +140,82 @@ decltype(transformable::transformations) transformable::parse(const std::string&
 			return ret; // unknown transformation, stop parsing
 		}
 
-		skip_whitespaces(s);
-
-		if(s.get() != '('){
-//			TRACE(<< "error: expected '('" << std::endl)
-			return ret; // expected (
-		}
-
-		skip_whitespaces(s);
-
-		switch(t.type_){
-			default:
-				ASSERT(false)
-				break;
-			case transformation::type::matrix:
-				t.a = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				t.b = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				t.c = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				t.d = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				t.e = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				t.f = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				break;
-			case transformation::type::translate:
-				t.x = read_in_real(s);
-				if(s.fail()){
-//					TRACE(<< "failed to read in x translation" << std::endl)
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				t.y = read_in_real(s);
-				if(s.fail()){
-//					TRACE(<< "failed to read in y translation" << std::endl)
-					s.clear();
-					t.y = 0;
-				}
-//				TRACE(<< "translation read: x,y = " << t.x << ", " << t.y << std::endl)
-				break;
-			case transformation::type::scale:
-				t.x = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				t.y = read_in_real(s);
-				if(s.fail()){
-					s.clear();
-					t.y = t.x;
-				}
-				break;
-			case transformation::type::rotate:
-				t.angle = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				skip_whitespaces_and_comma(s);
-				t.x = read_in_real(s);
-				if(s.fail()){
-					s.clear();
-					t.x = 0;
-					t.y = 0;
-				}else{
-					skip_whitespaces_and_comma(s);
-					t.y = read_in_real(s);
-					if(s.fail()){
-						return ret; // malformed rotate transformation
+		try{
+			p.skip_whitespaces();
+
+			if(p.read_char() != '('){
+//				TRACE(<< "error: expected '('" << std::endl)
+				return ret; // expected (
+			}
+
+			switch(t.type_){
+				default:
+					ASSERT(false)
+					break;
+				case transformation::type::matrix:
+					t.a = p.read_real();
+					p.skip_whitespaces_and_comma();
+					t.b = p.read_real();
+					p.skip_whitespaces_and_comma();
+					t.c = p.read_real();
+					p.skip_whitespaces_and_comma();
+					t.d = p.read_real();
+					p.skip_whitespaces_and_comma();
+					t.e = p.read_real();
+					p.skip_whitespaces_and_comma();
+					t.f = p.read_real();
+					break;
+				case transformation::type::translate:
+					t.x = p.read_real();
+					p.skip_whitespaces_and_comma();
+					try{
+						t.y = p.read_real();
+					}catch(std::invalid_argument&){
+//						TRACE(<< "failed to read in y translation" << std::endl)
+						t.y = 0;
 					}
-				}
-				break;
-			case transformation::type::skewy:
-			case transformation::type::skewx:
-				t.angle = read_in_real(s);
-				if(s.fail()){
-					return ret;
-				}
-				break;
-		}
-
-		skip_whitespaces(s);
-
-		if(s.get() != ')'){
-			return ret; // expected )
+//					TRACE(<< "translation read: x,y = " << t.x << ", " << t.y << std::endl)
+					break;
+				case transformation::type::scale:
+					t.x = p.read_real();
+					p.skip_whitespaces_and_comma();
+					try{
+						t.y = p.read_real();
+					}catch(std::invalid_argument&){
+						t.y = t.x;
+					}
+					break;
+				case transformation::type::rotate:
+					t.angle = p.read_real();
+					p.skip_whitespaces_and_comma();
+					try{
+						t.x = p.read_real();
+					}catch(std::invalid_argument&){
+						t.x = 0;
+						t.y = 0;
+						break;
+					}
+					p.skip_whitespaces_and_comma();
+					t.y = p.read_real(); // if x is specified then y is mandatory
+					break;
+				case transformation::type::skewy:
+				case transformation::type::skewx:
+					t.angle = p.read_real();
+					break;
+			}
+
+			p.skip_whitespaces();
+
+			if(p.read_char() != ')'){
+				return ret; // expected )
+			}
+		}catch(std::invalid_argument&){
+			return ret; // malformed transformation
 		}
 
 		ret.push_back(t);
 
-		skip_whitespaces_and_comma(s);
+		p.skip_whitespaces_and_comma();
 	}
 
 	return ret;
@@ -2,8 +2,10 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 
 #include "../config.hpp"
+#include "lazy_attribute.hpp"
 
 namespace svgdom{
 
@@ -41,11 +43,100 @@ struct transformable{
 		real d, e, f;
 	};
 
-	std::vector<transformation> transformations;
+	/**
+	 * @brief List of transformations.
+	 * Provides a subset of std::vector interface.
+	 * Can hold unparsed transformations string which is parsed on first access, see set_lazy().
+	 */
+	class transformation_list{
+		// mutable because lazily parsed transformations are filled in on first access
+		mutable std::vector<transformation> values;
+
+		lazy_attribute lazy;
+
+		void ensure_parsed()const;
+	public:
+		typedef decltype(values)::iterator iterator;
+		typedef decltype(values)::const_iterator const_iterator;
+
+		transformation_list() = default;
+
+		transformation_list(const transformation_list& l);
+		transformation_list& operator=(const transformation_list& l);
+
+		transformation_list(transformation_list&&) = default;
+		transformation_list& operator=(transformation_list&&) = default;
+
+		iterator begin(){
+			this->ensure_parsed();
+			return this->values.begin();
+		}
+
+		iterator end(){
+			this->ensure_parsed();
+			return this->values.end();
+		}
+
+		const_iterator begin()const{
+			this->ensure_parsed();
+			return this->values.begin();
+		}
+
+		const_iterator end()const{
+			this->ensure_parsed();
+			return this->values.end();
+		}
+
+		size_t size()const{
+			this->ensure_parsed();
+			return this->values.size();
+		}
+
+		bool empty()const{
+			this->ensure_parsed();
+			return this->values.empty();
+		}
+
+		void clear()noexcept{
+			this->lazy.reset();
+			this->values.clear();
+		}
+
+		transformation& operator[](size_t i){
+			this->ensure_parsed();
+			return this->values[i];
+		}
+
+		const transformation& operator[](size_t i)const{
+			this->ensure_parsed();
+			return this->values[i];
+		}
+
+		void push_back(const transformation& t){
+			this->ensure_parsed();
+			this->values.push_back(t);
+		}
+
+		/**
+		 * @brief Set transformations string to be parsed on first access.
+		 * Replaces current transformations.
+		 * @param str - transformations string, i.e. value of 'transform' attribute.
+		 */
+		void set_lazy(std::string str);
+	};
+
+	transformation_list transformations;
 	
 	std::string transformations_to_string()const;
+
+	/**
+	 * @brief Append transformations to string.
+	 * Appends the transformations in the format of 'transform' attribute value.
+	 * @param s - string to append the transformations to.
+	 */
+	void append_transformations(std::string& s)const;
 	
-	static decltype(transformable::transformations) parse(const std::string& str);
+	static decltype(transformable::transformations) parse(std::string_view str);
 };
 
 }
@@ -1,40 +1,45 @@
 #include "view_boxed.hpp"
 
+#include <sstream>
+
 #include <utki/debug.hpp>
 
 #include "../util.hxx"
 
 using namespace svgdom;
 
-decltype(view_boxed::view_box) view_boxed::parse_view_box(const std::string& str){
-	std::istringstream s(str);
-	
-	s >> std::skipws;
+decltype(view_boxed::view_box) view_boxed::parse_view_box(std::string_view str){
+	string_parser p(str);
 	
 	decltype(view_boxed::view_box) ret;
 	
-	for(unsigned i = 0; i != ret.size(); ++i){
-		skip_whitespaces_and_comma(s);
-		ret[i] = read_in_real(s);
-		if(s.fail()){
-			return {{-1, -1, -1, -1}};
+	try{
+		for(auto& v : ret){
+			p.skip_whitespaces_and_comma();
+			v = p.read_real();
 		}
+	}catch(std::invalid_argument&){
+		return {{-1, -1, -1, -1}};
 	}
 	
 	return ret;
 }
 
 std::string view_boxed::view_box_to_string()const{
-	std::stringstream s;
+	std::string s;
+	this->append_view_box(s);
+	return s;
+}
+
+void view_boxed::append_view_box(std::string& s)const{
 	bool isFirst = true;
 	for (auto i = this->view_box.begin(); i != this->view_box.end(); ++i) {
 		if (isFirst) {
 			isFirst = false;
 		}
 		else {
-			s << " ";
+			s += ' ';
 		}
-		s << (*i);
+		append_real(s, *i);
 	}
-	return s.str();
 }
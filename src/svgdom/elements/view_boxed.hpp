@@ -2,6 +2,7 @@
 
 #include <array>
 #include <string>
+#include <string_view>
 
 #include "../config.hpp"
 
@@ -16,7 +17,13 @@ struct view_boxed{
 
 	std::string view_box_to_string()const;
 
-	static decltype(view_box) parse_view_box(const std::string& str);
+	/**
+	 * @brief Append viewBox attribute value to string.
+	 * @param s - string to append the value to.
+	 */
+	void append_view_box(std::string& s)const;
+
+	static decltype(view_box) parse_view_box(std::string_view str);
 
 	bool is_view_box_specified()const{
 		return this->view_box[2] >= 0; // width is not negative
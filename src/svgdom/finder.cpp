@@ -1,107 +1,121 @@
 #include "finder.hpp"
 
+#include <algorithm>
+
 #include <utki/debug.hpp>
 
-#include "visitor.hpp"
+#include "visit_tree.hpp"
 
 using namespace svgdom;
 
 namespace{
-class CacheCreator : virtual public svgdom::const_visitor{
+class CacheCreator{
 public:
-	std::map<std::string, finder::element_info> cache;
+	constexpr static size_t npos = ~size_t(0);
+
+	// styleable elements with indices of their parents in this table
+	std::vector<std::pair<const svgdom::styleable*, size_t>> ancestry;
+
+	// elements with ids and indices of their closest styleable ancestors-or-self
+	std::vector<std::pair<const svgdom::element*, size_t>> elements;
 	
-	style_stack styleStack;
+	size_t cur = npos;
 	
 	void addToCache(const svgdom::element& e){
 		if(!e.id.empty()){
-			this->cache.insert(std::make_pair(e.id, finder::element_info(e, this->styleStack)));
+			this->elements.emplace_back(&e, this->cur);
 		}
 	}
-	
-	void visitContainer(const svgdom::element& e, const svgdom::container& c, const svgdom::styleable& s){
-		style_stack::push push(this->styleStack, s);
-		this->addToCache(e);
-		this->relay_accept(c);
-	}
-	void visitElement(const svgdom::element& e, const svgdom::styleable& s){
-		style_stack::push push(this->styleStack, s);
-		this->addToCache(e);
-	}
-	
-	void default_visit(const svgdom::element& e)override{
-		this->addToCache(e);
-	}
-	
-	void visit(const svgdom::g_element& e) override{
-		this->visitContainer(e, e, e);
-	}
-	void visit(const svgdom::symbol_element& e) override{
-		this->visitContainer(e, e, e);
-	}
-	void visit(const svgdom::svg_element& e) override{
-		this->visitContainer(e, e, e);
-	}
-	void visit(const svgdom::radial_gradient_element& e) override{
-		this->visitContainer(e, e, e);
-	}
-	void visit(const svgdom::linear_gradient_element& e) override{
-		this->visitContainer(e, e, e);
-	}
-	void visit(const svgdom::defs_element& e) override{
-		this->visitContainer(e, e, e);
-	}
-	void visit(const svgdom::filter_element& e) override{
-		this->visitContainer(e, e, e);
-	}
-	
-	void visit(const svgdom::polyline_element& e) override{
-		this->visitElement(e, e);
-	}
-	void visit(const svgdom::circle_element& e) override{
-		this->visitElement(e, e);
-	}
-	void visit(const svgdom::use_element& e) override{
-		this->visitElement(e, e);
-	}
-	void visit(const svgdom::gradient::stop_element& e) override{
-		this->visitElement(e, e);
-	}
-	void visit(const svgdom::path_element& e) override{
-		this->visitElement(e, e);
+
+	// adds styleable to the ancestry table and makes it current until destroyed
+	class push{
+		CacheCreator& cc;
+		size_t prev;
+	public:
+		push(CacheCreator& cc, const svgdom::styleable& s) :
+				cc(cc),
+				prev(cc.cur)
+		{
+			cc.cur = cc.ancestry.size();
+			cc.ancestry.emplace_back(&s, this->prev);
+		}
+
+		~push()noexcept{
+			this->cc.cur = this->prev;
+		}
+	};
+
+	template <class T> void addChildren(const T& e){
+		if constexpr (std::is_base_of<svgdom::container, T>::value){
+			for(auto& c : e.children){
+				this->add(*c);
+			}
+		}
 	}
-	void visit(const svgdom::rect_element& e) override{
-		this->visitElement(e, e);
+
+	// custom elements are added to the cache, but their children are not
+	void add(const svgdom::element& e){
+		svgdom::visit_element(e, [this](const auto& e){
+			typedef std::remove_const_t<std::remove_reference_t<decltype(e)>> type;
+
+			if constexpr (std::is_base_of<svgdom::styleable, type>::value){
+				push p(*this, e);
+				this->addToCache(e);
+				this->addChildren(e);
+			}else{
+				this->addToCache(e);
+				this->addChildren(e);
+			}
+		});
 	}
-	void visit(const svgdom::line_element& e) override{
-		this->visitElement(e, e);
+};
+}
+
+finder::finder(const svgdom::element& root){
+	CacheCreator creator;
+
+	creator.add(root);
+
+	// parents precede their descendants in the table, so the parent pointers are set before
+	// and the table is not reallocated while it is filled
+	this->ancestry.reserve(creator.ancestry.size());
+	for(auto& a : creator.ancestry){
+		this->ancestry.push_back(ancestor{
+				*a.first,
+				a.second == CacheCreator::npos ? nullptr : &this->ancestry[a.second]
+			});
 	}
-	void visit(const svgdom::ellipse_element& e) override{
-		this->visitElement(e, e);
+
+	this->cache.reserve(creator.elements.size());
+	for(auto& e : creator.elements){
+		this->cache.emplace(
+				std::string_view(e.first->id),
+				element_info(*e.first, e.second == CacheCreator::npos ? nullptr : &this->ancestry[e.second])
+			);
 	}
-	void visit(const svgdom::polygon_element& e) override{
-		this->visitElement(e, e);
-	}	
-	void visit(const svgdom::fe_gaussian_blur_element& e) override{
-		this->visitElement(e, e);
+}
+
+finder::finder(const finder& f) :
+		ancestry(f.ancestry)
+{
+	auto rebase = [this, &f](const ancestor* a) -> const ancestor*{
+		if(!a){
+			return nullptr;
+		}
+		return &this->ancestry[a - f.ancestry.data()];
+	};
+
+	for(auto& a : this->ancestry){
+		a.parent = rebase(a.parent);
 	}
-	void visit(const image_element& e) override{
-		this->visitElement(e, e);
+
+	this->cache.reserve(f.cache.size());
+	for(auto& i : f.cache){
+		this->cache.emplace(i.first, element_info(i.second.e, rebase(i.second.ancestor)));
 	}
-};
 }
 
-finder::finder(const svgdom::element& root) :
-		cache([&root](){
-			CacheCreator visitor;
-	
-			root.accept(visitor);
-			
-			return std::move(visitor.cache);
-		}())
-{}
-
-const finder::element_info* finder::find_by_id(const std::string& id)const{
+const finder::element_info* finder::find_by_id(std::string_view id)const{
 	if(id.length() == 0){
 		return nullptr;
 	}
@@ -110,6 +124,45 @@ const finder::element_info* finder::find_by_id(const std::string& id)const{
 	if(i == this->cache.end()){
 		return nullptr;
 	}
+
+	ASSERT_INFO(i->first.data() == i->second.e.id.data() && i->first.size() == i->second.e.id.size(), "id of element '" << i->second.e.id << "' was changed after creating the finder")
 	
 	return &i->second;
 }
+
+bool finder::is_valid()const{
+	for(size_t b = 0; b != this->cache.bucket_count(); ++b){
+		for(auto i = this->cache.begin(b); i != this->cache.end(b); ++i){
+			// the key must still refer to the id of the element and the id must hash to the same bucket
+			if(i->first.data() != i->second.e.id.data() || i->first.size() != i->second.e.id.size()){
+				return false;
+			}
+			if(this->cache.bucket(i->first) != b){
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+namespace{
+style_stack make_style_stack(const finder::ancestor* a){
+	style_stack ret;
+
+	for(; a; a = a->parent){
+		ret.stack.push_back(a->s);
+	}
+	std::reverse(ret.stack.begin(), ret.stack.end());
+
+	return ret;
+}
+}
+
+style_stack finder::get_style_stack(const element_info& i)const{
+	ASSERT(!i.ancestor || (this->ancestry.data() <= i.ancestor && i.ancestor < this->ancestry.data() + this->ancestry.size()))
+	return make_style_stack(i.ancestor);
+}
+
+style_stack finder::element_info::ss()const{
+	return make_style_stack(this->ancestor);
+}
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <map>
+#include <vector>
+#include <string_view>
+#include <unordered_map>
 
 #include "elements/element.hpp"
 
@@ -8,23 +10,74 @@
 
 namespace svgdom{
 
+/**
+ * @brief Index of elements by id.
+ * Keeps references to the elements and to their ids, so the document must not be
+ * modified while the finder is in use. In particular, ids of the elements must not be
+ * changed, see is_valid().
+ */
 class finder{
 public:
 	
 	finder(const svgdom::element& root);
+
+	finder(const finder& f);
+	finder& operator=(const finder&) = delete;
+
+	finder(finder&&) = default;
+	finder& operator=(finder&&) = default;
+
+	struct ancestor;
 	
 	struct element_info{
 		const svgdom::element& e;
-		const style_stack ss;
+
+		// closest styleable ancestor-or-self in the ancestry table, nullptr if none
+		const finder::ancestor* ancestor;
 		
-		element_info(const svgdom::element& e, style_stack ss) :
+		element_info(const svgdom::element& e, const finder::ancestor* ancestor) :
 				e(e),
-				ss(ss)
+				ancestor(ancestor)
 		{}
+
+		/**
+		 * @brief Get style stack of the element.
+		 * Note, that this is a breaking change: the style stack used to be a data member 'ss',
+		 * now it is not stored anymore and is reconstructed on each call, so 'info->ss' has to be
+		 * replaced with 'info->ss()' or, better, with finder::get_style_stack().
+		 * @return style stack of the element, same as finder::get_style_stack() returns.
+		 */
+		[[deprecated("use finder::get_style_stack()")]]
+		style_stack ss()const;
 	};
 
-	const element_info* find_by_id(const std::string& id)const;
+	const element_info* find_by_id(std::string_view id)const;
+
+	const element_info* find_by_id(const char* id)const{
+		return this->find_by_id(std::string_view(id));
+	}
+
+	// kept for compatibility
+	const element_info* find_by_id(const std::string& id)const{
+		return this->find_by_id(std::string_view(id));
+	}
+
+	/**
+	 * @brief Get style stack of the element.
+	 * The style stack is reconstructed from the ancestry table on each call.
+	 * @param i - element info returned by find_by_id() of this finder.
+	 * @return style stack containing styleable ancestors of the element, and the element itself if it is styleable.
+	 */
+	style_stack get_style_stack(const element_info& i)const;
 	
+	/**
+	 * @brief Check that ids of the elements were not changed since the finder was created.
+	 * Checks all the elements, so it takes time linear to the number of elements.
+	 * Intended for debugging.
+	 * @return true if ids of all the elements in the cache are unchanged.
+	 */
+	bool is_valid()const;
+
 	/**
 	 * @brief Get cache size.
 	 * @return number of cached elements.
@@ -33,8 +86,21 @@ public:
 		return this->cache.size();
 	}
 
+	/**
+	 * @brief Styleable element in the ancestry table.
+	 */
+	struct ancestor{
+		const styleable& s;
+		const ancestor* parent; // nullptr for the root
+	};
+
 private:
-	std::map<std::string, element_info> cache;
+	// styleable elements of the document in depth-first order, each one linked to its closest styleable ancestor,
+	// the pointers stay valid when the finder is moved
+	std::vector<ancestor> ancestry;
+
+	// keys refer to ids of the elements
+	std::unordered_map<std::string_view, element_info> cache;
 };
 
 }
@@ -0,0 +1,99 @@
+#include "id_index.hpp"
+
+#include <utki/debug.hpp>
+
+#include "visit_tree.hpp"
+
+using namespace svgdom;
+
+id_index::id_index(element& root){
+	this->add_subtree(root);
+}
+
+void id_index::add(element& e){
+	if(e.id.empty()){
+		return;
+	}
+
+	if(!this->ids.emplace(std::string_view(e.id), &e).second){
+		this->shadowed.emplace(std::string_view(e.id), &e);
+	}
+}
+
+void id_index::erase(element& e){
+	if(e.id.empty()){
+		return;
+	}
+
+	auto i = this->ids.find(e.id);
+	ASSERT(i != this->ids.end())
+
+	if(i->second != &e){
+		auto range = this->shadowed.equal_range(e.id);
+		for(auto j = range.first; j != range.second; ++j){
+			if(j->second == &e){
+				this->shadowed.erase(j);
+				return;
+			}
+		}
+		ASSERT(false)
+		return;
+	}
+
+	this->ids.erase(i);
+
+	// key refers to the id of the removed element, so promoted element is added with its own key
+	auto j = this->shadowed.find(e.id);
+	if(j != this->shadowed.end()){
+		auto promoted = j->second;
+		this->shadowed.erase(j);
+		this->ids.emplace(std::string_view(promoted->id), promoted);
+	}
+}
+
+void id_index::add_subtree(element& e){
+	visit_tree(e, [this](element& d){this->add(d);});
+}
+
+void id_index::erase_subtree(element& e){
+	visit_tree(e, [this](element& d){this->erase(d);});
+}
+
+element* id_index::find_by_id(std::string_view id)const{
+	if(id.length() == 0){
+		return nullptr;
+	}
+
+	auto i = this->ids.find(id);
+	if(i == this->ids.end()){
+		return nullptr;
+	}
+
+	return i->second;
+}
+
+decltype(container::children)::iterator id_index::insert(
+		container& parent,
+		decltype(container::children)::iterator pos,
+		std::unique_ptr<element> e
+	)
+{
+	ASSERT(e)
+	auto ret = parent.children.insert(pos, std::move(e));
+	this->add_subtree(**ret);
+	return ret;
+}
+
+std::unique_ptr<element> id_index::remove(container& parent, decltype(container::children)::iterator i){
+	ASSERT(i != parent.children.end())
+	auto ret = std::move(*i);
+	parent.children.erase(i);
+	this->erase_subtree(*ret);
+	return ret;
+}
+
+void id_index::set_id(element& e, std::string id){
+	this->erase(e);
+	e.id = std::move(id);
+	this->add(e);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "elements/container.hpp"
+
+namespace svgdom{
+
+/**
+ * @brief Incrementally maintained index of elements by id.
+ * Unlike finder, which has to be rebuilt after each modification of the document, this index
+ * is kept up to date while the document is modified through its mutation methods: insert(), remove()
+ * and set_id(). Cost of each modification is proportional to the size of the inserted or removed subtree,
+ * not to the size of the document.
+ * The index keeps pointers to the elements and refers to their ids, so while the index is in use the
+ * document must not be modified other than through the mutation methods of the index, except for
+ * changing attributes other than id.
+ * If several elements have same id, then find_by_id() returns the one which was indexed first.
+ * When that element is removed, one of the remaining elements with the same id takes its place.
+ */
+class id_index{
+	// keys refer to ids of the elements
+	std::unordered_map<std::string_view, element*> ids;
+
+	// elements whose ids are already taken by other elements
+	std::unordered_multimap<std::string_view, element*> shadowed;
+
+	void add(element& e);
+	void erase(element& e);
+
+	void add_subtree(element& e);
+	void erase_subtree(element& e);
+public:
+	/**
+	 * @brief Create index of document.
+	 * Indexes all the elements of the document tree.
+	 * @param root - root element of the document.
+	 */
+	id_index(element& root);
+
+	id_index(const id_index&) = delete;
+	id_index& operator=(const id_index&) = delete;
+
+	/**
+	 * @brief Find element by id.
+	 * @param id - id of the element to find.
+	 * @return pointer to the element with given id.
+	 * @return nullptr if there is no element with given id.
+	 */
+	element* find_by_id(std::string_view id)const;
+
+	/**
+	 * @brief Insert element to document.
+	 * The element and all its descendants are added to the index.
+	 * @param parent - container in the document to insert the element to.
+	 * @param pos - position in the parent's children list to insert the element before.
+	 * @param e - element to insert.
+	 * @return iterator of the inserted element in the parent's children list.
+	 */
+	decltype(container::children)::iterator insert(
+			container& parent,
+			decltype(container::children)::iterator pos,
+			std::unique_ptr<element> e
+		);
+
+	/**
+	 * @brief Remove element from document.
+	 * The element and all its descendants are removed from the index.
+	 * @param parent - container in the document to remove the element from.
+	 * @param i - iterator of the element in the parent's children list.
+	 * @return removed element.
+	 */
+	std::unique_ptr<element> remove(container& parent, decltype(container::children)::iterator i);
+
+	/**
+	 * @brief Change id of element.
+	 * @param e - element of the document to change id of.
+	 * @param id - new id of the element.
+	 */
+	void set_id(element& e, std::string id);
+
+	/**
+	 * @brief Get number of indexed ids.
+	 * @return number of distinct ids in the index.
+	 */
+	size_t size()const noexcept{
+		return this->ids.size();
+	}
+};
+
+}
@@ -1,25 +1,26 @@
 #include "length.hpp"
 
-#include <sstream>
-#include <iomanip>
+#include <ostream>
 #include <cmath>
 
 #include "util.hxx"
 
 using namespace svgdom;
 
-length length::parse(const std::string& str) {
+length length::parse(std::string_view str) {
 	length ret;
 
-	std::istringstream ss(str);
+	string_parser p(str);
 	
-	ss >> std::skipws;
-	
-	ret.value = read_in_real(ss);
+	try{
+		ret.value = p.read_real();
+	}catch(std::invalid_argument&){
+		ret.value = 0;
+	}
 	
-	std::string u;
+	p.skip_whitespaces();
 	
-	ss >> std::setw(2) >> u >> std::setw(0);
+	auto u = p.read_word().substr(0, 2);
 	
 	if(u.length() == 0){
 		ret.unit = length_unit::number;
@@ -73,41 +74,7 @@ real length::to_px(real dpi) const noexcept{
 }
 
 std::ostream& operator<<(std::ostream& s, const length& l){
-	s << l.value;
-	
-	switch(l.unit){
-		case length_unit::unknown:
-		case length_unit::number:
-		default:
-			break;
-		case length_unit::percent:
-			s << "%";
-			break;
-		case length_unit::em:
-			s << "em";
-			break;
-		case length_unit::ex:
-			s << "ex";
-			break;
-		case length_unit::px:
-			s << "px";
-			break;
-		case length_unit::cm:
-			s << "cm";
-			break;
-		case length_unit::mm:
-			s << "mm";
-			break;
-		case length_unit::in:
-			s << "in";
-			break;
-		case length_unit::pt:
-			s << "pt";
-			break;
-		case length_unit::pc:
-			s << "pc";
-			break;
-	}
-	
-	return s;
+	std::string str;
+	append_length(str, l);
+	return s << str;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "config.hpp"
 
@@ -31,7 +32,7 @@ struct length{
 	real value;
 	length_unit unit;
 	
-	static length parse(const std::string& str);
+	static length parse(std::string_view str);
 	
 	length() = default;
 
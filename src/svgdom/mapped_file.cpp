@@ -0,0 +1,106 @@
+#include "mapped_file.hxx"
+
+#include <system_error>
+
+#if M_OS == M_OS_WINDOWS
+#	include <windows.h>
+#else
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <cerrno>
+#endif
+
+using namespace svgdom;
+
+#if M_OS == M_OS_WINDOWS
+
+mapped_file::mapped_file(const std::string& path){
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE){
+		throw std::system_error(int(GetLastError()), std::system_category(), "mapped_file: could not open file " + path);
+	}
+
+	LARGE_INTEGER file_size;
+	if(!GetFileSizeEx(file, &file_size)){
+		auto error = GetLastError();
+		CloseHandle(file);
+		throw std::system_error(int(error), std::system_category(), "mapped_file: could not get size of file " + path);
+	}
+
+	if(file_size.QuadPart == 0){
+		// empty files cannot be mapped
+		CloseHandle(file);
+		return;
+	}
+
+	this->mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	auto error = GetLastError();
+	CloseHandle(file); // the mapping holds its own reference to the file
+	if(!this->mapping){
+		throw std::system_error(int(error), std::system_category(), "mapped_file: could not map file " + path);
+	}
+
+	auto view = MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0);
+	if(!view){
+		error = GetLastError();
+		CloseHandle(this->mapping);
+		throw std::system_error(int(error), std::system_category(), "mapped_file: could not map file " + path);
+	}
+
+	this->data = static_cast<const char*>(view);
+	this->size = size_t(file_size.QuadPart);
+}
+
+mapped_file::~mapped_file()noexcept{
+	if(this->data){
+		UnmapViewOfFile(this->data);
+	}
+	if(this->mapping){
+		CloseHandle(this->mapping);
+	}
+}
+
+#else
+
+mapped_file::mapped_file(const std::string& path){
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0){
+		throw std::system_error(errno, std::generic_category(), "mapped_file: could not open file " + path);
+	}
+
+	struct stat st;
+	if(fstat(fd, &st) != 0){
+		auto error = errno;
+		close(fd);
+		throw std::system_error(error, std::generic_category(), "mapped_file: could not get size of file " + path);
+	}
+
+	if(st.st_size == 0){
+		// empty files cannot be mapped
+		close(fd);
+		return;
+	}
+
+	void* p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	auto error = errno;
+	close(fd); // the mapping holds its own reference to the file
+	if(p == MAP_FAILED){
+		throw std::system_error(error, std::generic_category(), "mapped_file: could not map file " + path);
+	}
+
+	// the whole file is going to be parsed from beginning to end
+	madvise(p, size_t(st.st_size), MADV_SEQUENTIAL);
+
+	this->data = static_cast<const char*>(p);
+	this->size = size_t(st.st_size);
+}
+
+mapped_file::~mapped_file()noexcept{
+	if(this->data){
+		munmap(const_cast<char*>(this->data), this->size);
+	}
+}
+
+#endif
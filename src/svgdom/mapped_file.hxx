@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+
+#include <utki/config.hpp>
+#include <utki/span.hpp>
+
+namespace svgdom{
+
+/**
+ * @brief Read-only memory mapping of a whole local file.
+ * The file contents are accessible for the lifetime of the object.
+ */
+class mapped_file{
+	const char* data = nullptr;
+	size_t size = 0;
+
+#if M_OS == M_OS_WINDOWS
+	void* mapping = nullptr;
+#endif
+
+public:
+	/**
+	 * @brief Map file to memory.
+	 * @param path - path to the file in local file system.
+	 * @throw std::system_error - in case the file could not be opened or mapped.
+	 */
+	mapped_file(const std::string& path);
+
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	~mapped_file()noexcept;
+
+	/**
+	 * @brief Get file contents.
+	 * @return span of the mapped file contents.
+	 */
+	utki::span<const char> span()const noexcept{
+		return utki::make_span(this->data, this->size);
+	}
+};
+
+}
@@ -0,0 +1,76 @@
+#include "node_table.hpp"
+
+#include "visit_tree.hpp"
+
+using namespace svgdom;
+
+namespace{
+class node_table_builder{
+	std::vector<node_table::node>& table;
+
+	uint32_t cur_parent = node_table::npos;
+	uint32_t prev_sibling = node_table::npos;
+	uint32_t depth = 0;
+public:
+	node_table_builder(std::vector<node_table::node>& table) :
+			table(table)
+	{}
+
+	void add(const element& e){
+		const container* c = nullptr;
+
+		visit_element(e, [&c](const auto& e){
+			typedef std::remove_const_t<std::remove_reference_t<decltype(e)>> type;
+
+			if constexpr (std::is_base_of<container, type>::value){
+				c = &e;
+			}else if constexpr (std::is_same<element, type>::value){
+				c = dynamic_cast<const container*>(&e);
+			}
+		});
+
+		auto index = uint32_t(this->table.size());
+		this->table.push_back(node_table::node{
+				&e,
+				this->cur_parent,
+				node_table::npos,
+				node_table::npos,
+				this->depth,
+				1,
+				e.get_type()
+			});
+
+		if(this->prev_sibling != node_table::npos){
+			this->table[this->prev_sibling].next_sibling = index;
+		}else if(this->cur_parent != node_table::npos){
+			this->table[this->cur_parent].first_child = index;
+		}
+		this->prev_sibling = index;
+
+		if(!c){
+			return;
+		}
+
+		auto old_parent = this->cur_parent;
+		this->cur_parent = index;
+		this->prev_sibling = node_table::npos;
+		++this->depth;
+
+		for(auto& child : c->children){
+			this->add(*child);
+		}
+
+		--this->depth;
+		this->cur_parent = old_parent;
+		this->prev_sibling = index;
+
+		this->table[index].subtree_size = uint32_t(this->table.size()) - index;
+	}
+};
+}
+
+node_table::node_table(const svgdom::element& root){
+	node_table_builder b(this->table);
+	b.add(root);
+	this->table.shrink_to_fit();
+}
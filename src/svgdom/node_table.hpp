@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "elements/element.hpp"
+#include "elements/element_type.hpp"
+
+namespace svgdom{
+
+/**
+ * @brief Flattened topology of a document tree.
+ * Holds one record per element of the tree in a contiguous array, in document order (pre-order).
+ * Records are linked to each other by indices, which allows navigating the tree upwards and
+ * sideways, and thanks to the pre-order layout, subtree and ancestor queries are done without
+ * walking the tree and without virtual calls.
+ * The table is a snapshot of the tree structure, it has to be rebuilt after adding or removing
+ * elements, and the elements must outlive the table.
+ */
+class node_table{
+public:
+	/**
+	 * @brief Index value meaning 'no node'.
+	 */
+	constexpr static uint32_t npos = ~uint32_t(0);
+
+	/**
+	 * @brief Node record.
+	 */
+	struct node{
+		const svgdom::element* e;
+		uint32_t parent; // npos for the root node
+		uint32_t first_child; // npos if node has no children
+		uint32_t next_sibling; // npos for the last child
+		uint32_t depth; // 0 for the root node
+		uint32_t subtree_size; // number of nodes in the subtree, including the node itself
+		element_type type; // element_type::unknown for custom elements
+	};
+
+private:
+	std::vector<node> table;
+public:
+	/**
+	 * @brief Build node table of the tree.
+	 * @param root - root element of the tree.
+	 */
+	node_table(const svgdom::element& root);
+
+	/**
+	 * @brief Get all nodes.
+	 * @return nodes in pre-order, the root node has index 0.
+	 */
+	const std::vector<node>& nodes()const noexcept{
+		return this->table;
+	}
+
+	size_t size()const noexcept{
+		return this->table.size();
+	}
+
+	const node& operator[](uint32_t i)const noexcept{
+		return this->table[i];
+	}
+
+	/**
+	 * @brief Get index after the last node of the subtree.
+	 * Nodes of the subtree occupy the range [i, subtree_end(i)) of the table.
+	 * @param i - index of the subtree's root node.
+	 * @return index following the last node of the subtree.
+	 */
+	uint32_t subtree_end(uint32_t i)const noexcept{
+		return i + this->table[i].subtree_size;
+	}
+
+	/**
+	 * @brief Check if one node is a proper ancestor of another.
+	 * @param ancestor - index of the supposed ancestor node.
+	 * @param descendant - index of the supposed descendant node.
+	 * @return true if 'ancestor' is a proper ancestor of 'descendant'.
+	 * @return false otherwise.
+	 */
+	bool is_ancestor(uint32_t ancestor, uint32_t descendant)const noexcept{
+		return ancestor < descendant && descendant < this->subtree_end(ancestor);
+	}
+};
+
+}
@@ -2,13 +2,15 @@
 #include "util.hxx"
 #include "malformed_svg_error.hpp"
 #include "casters.hpp"
+#include "perfect_hash.hxx"
 
 #include <utki/debug.hpp>
 #include <utki/util.hpp>
-#include <utki/string.hpp>
 
 #include <papki/span_file.hpp>
 
+#include <algorithm>
+
 using namespace svgdom;
 
 namespace{
@@ -17,7 +19,7 @@ const std::string DXlinkNamespace = "http://www.w3.org/1999/xlink";
 }
 
 namespace{
-gradient::spread_method gradientStringToSpreadMethod(const std::string& str){
+gradient::spread_method gradientStringToSpreadMethod(std::string_view str){
 	if(str == "pad"){
 		return gradient::spread_method::pad;
 	}else if(str == "reflect"){
@@ -29,14 +31,108 @@ gradient::spread_method gradientStringToSpreadMethod(const std::string& str){
 }
 }
 
+namespace{
+constexpr auto tags_map = make_perfect_hash_map<svg_tag>({
+		{"svg", svg_tag::svg},
+		{"symbol", svg_tag::symbol},
+		{"g", svg_tag::g},
+		{"defs", svg_tag::defs},
+		{"use", svg_tag::use},
+		{"path", svg_tag::path},
+		{"linearGradient", svg_tag::linear_gradient},
+		{"radialGradient", svg_tag::radial_gradient},
+		{"stop", svg_tag::stop},
+		{"rect", svg_tag::rect},
+		{"circle", svg_tag::circle},
+		{"ellipse", svg_tag::ellipse},
+		{"line", svg_tag::line},
+		{"polyline", svg_tag::polyline},
+		{"polygon", svg_tag::polygon},
+		{"filter", svg_tag::filter},
+		{"feGaussianBlur", svg_tag::fe_gaussian_blur},
+		{"feColorMatrix", svg_tag::fe_color_matrix},
+		{"feBlend", svg_tag::fe_blend},
+		{"feComposite", svg_tag::fe_composite},
+		{"image", svg_tag::image},
+		{"mask", svg_tag::mask},
+		{"text", svg_tag::text},
+		{"style", svg_tag::style},
+	});
+
+constexpr auto attributes_map = make_perfect_hash_map<svg_attribute>({
+		{"class", svg_attribute::class_},
+		{"cx", svg_attribute::cx},
+		{"cy", svg_attribute::cy},
+		{"d", svg_attribute::d},
+		{"filterUnits", svg_attribute::filter_units},
+		{"fx", svg_attribute::fx},
+		{"fy", svg_attribute::fy},
+		{"gradientTransform", svg_attribute::gradient_transform},
+		{"gradientUnits", svg_attribute::gradient_units},
+		{"height", svg_attribute::height},
+		{"href", svg_attribute::href},
+		{"id", svg_attribute::id},
+		{"in", svg_attribute::in},
+		{"in2", svg_attribute::in2},
+		{"k1", svg_attribute::k1},
+		{"k2", svg_attribute::k2},
+		{"k3", svg_attribute::k3},
+		{"k4", svg_attribute::k4},
+		{"maskContentUnits", svg_attribute::mask_content_units},
+		{"maskUnits", svg_attribute::mask_units},
+		{"mode", svg_attribute::mode},
+		{"offset", svg_attribute::offset},
+		{"operator", svg_attribute::operator_},
+		{"points", svg_attribute::points},
+		{"preserveAspectRatio", svg_attribute::preserve_aspect_ratio},
+		{"primitiveUnits", svg_attribute::primitive_units},
+		{"r", svg_attribute::r},
+		{"result", svg_attribute::result},
+		{"rx", svg_attribute::rx},
+		{"ry", svg_attribute::ry},
+		{"spreadMethod", svg_attribute::spread_method},
+		{"stdDeviation", svg_attribute::std_deviation},
+		{"style", svg_attribute::style},
+		{"transform", svg_attribute::transform},
+		{"type", svg_attribute::type},
+		{"values", svg_attribute::values},
+		{"viewBox", svg_attribute::view_box},
+		{"width", svg_attribute::width},
+		{"x", svg_attribute::x},
+		{"x1", svg_attribute::x1},
+		{"x2", svg_attribute::x2},
+		{"y", svg_attribute::y},
+		{"y1", svg_attribute::y1},
+		{"y2", svg_attribute::y2},
+	});
+}
+
+namespace{
+real parse_real_or_zero(std::string_view str){
+	try{
+		return string_parser(str).read_real();
+	}catch(std::invalid_argument&){
+		return 0;
+	}
+}
+}
+
 void parser::pushNamespaces(){
+	const std::string_view xmlns = "xmlns";
+	
 	//parse default namespace
 	{
-		auto i = this->attributes.find("xmlns");
+		auto i = std::find_if(
+				this->attributes.begin(),
+				this->attributes.end(),
+				[&xmlns](const attribute& a){
+					return a.qualified_name == xmlns;
+				}
+			);
 		if(i != this->attributes.end()){
-			if(i->second == DSvgNamespace){
+			if(i->value == DSvgNamespace){
 				this->defaultNamespaceStack.push_back(XmlNamespace_e::SVG);
-			}else if(i->second == DXlinkNamespace){
+			}else if(i->value == DXlinkNamespace){
 				this->defaultNamespaceStack.push_back(XmlNamespace_e::XLINK);
 			}else{
 				this->defaultNamespaceStack.push_back(XmlNamespace_e::UNKNOWN);
@@ -52,28 +148,23 @@ void parser::pushNamespaces(){
 	
 	//parse other namespaces
 	{
-		std::string xmlns = "xmlns:";
-		
 		this->namespacesStack.push_back(decltype(this->namespacesStack)::value_type());
 		
 		for(auto& e : this->attributes){
-			const auto& attr = e.first;
+			const auto& attr = e.qualified_name;
 			
-			if(attr.substr(0, xmlns.length()) != xmlns){
+			if(attr.length() <= xmlns.length() || attr.substr(0, xmlns.length()) != xmlns || attr[xmlns.length()] != ':'){
 				continue;
 			}
 			
-			ASSERT(attr.length() >= xmlns.length())
-			auto nsName = attr.substr(xmlns.length(), attr.length() - xmlns.length());
+			auto nsName = attr.substr(xmlns.length() + 1);
 			
-			if(e.second == DSvgNamespace){
-				this->namespacesStack.back()[nsName] = XmlNamespace_e::SVG;
-			}else if(e.second == DXlinkNamespace){
-				this->namespacesStack.back()[nsName] = XmlNamespace_e::XLINK;
+			if(e.value == DSvgNamespace){
+				this->namespacesStack.back()[std::string(nsName)] = XmlNamespace_e::SVG;
+			}else if(e.value == DXlinkNamespace){
+				this->namespacesStack.back()[std::string(nsName)] = XmlNamespace_e::XLINK;
 			}
 		}
-		
-		this->flippedNamespacesStack.push_back(utki::flip_map(this->namespacesStack.back()));
 	}
 }
 
@@ -82,8 +173,6 @@ void parser::popNamespaces(){
 	this->namespacesStack.pop_back();
 	ASSERT(this->defaultNamespaceStack.size() != 0)
 	this->defaultNamespaceStack.pop_back();
-	ASSERT(this->flippedNamespacesStack.size() != 0)
-	this->flippedNamespacesStack.pop_back();
 }
 
 void parser::parse_element(){
@@ -91,59 +180,84 @@ void parser::parse_element(){
 	// TRACE(<< "nsn.name = " << nsn.name << std::endl)
 	switch(nsn.ns){
 		case XmlNamespace_e::SVG:
-			if(nsn.name == svg_element::tag){
-				this->parseSvgElement();
-			}else if(nsn.name == symbol_element::tag){
-				this->parseSymbolElement();
-			}else if(nsn.name == g_element::tag){
-				this->parseGElement();
-			}else if(nsn.name == defs_element::tag){
-				this->parseDefsElement();
-			}else if(nsn.name == use_element::tag){
-				this->parseUseElement();
-			}else if(nsn.name == path_element::tag){
-				this->parsePathElement();
-			}else if(nsn.name == linear_gradient_element::tag){
-				this->parseLinearGradientElement();
-			}else if(nsn.name == radial_gradient_element::tag){
-				this->parseRadialGradientElement();
-			}else if(nsn.name == gradient::stop_element::tag){
-				this->parseGradientStopElement();
-			}else if(nsn.name == rect_element::tag){
-				this->parseRectElement();
-			}else if(nsn.name == circle_element::tag){
-				this->parseCircleElement();
-			}else if(nsn.name == ellipse_element::tag){
-				this->parseEllipseElement();
-			}else if(nsn.name == line_element::tag){
-				this->parseLineElement();
-			}else if(nsn.name == polyline_element::tag){
-				this->parsePolylineElement();
-			}else if(nsn.name == polygon_element::tag){
-				this->parsePolygonElement();
-			}else if(nsn.name == filter_element::tag){
-				this->parseFilterElement();
-			}else if(nsn.name == fe_gaussian_blur_element::tag){
-				this->parseFeGaussianBlurElement();
-			}else if(nsn.name == fe_color_matrix_element::tag){
-				this->parseFeColorMatrixElement();
-			}else if(nsn.name == fe_blend_element::tag){
-				this->parseFeBlendElement();
-			}else if(nsn.name == fe_composite_element::tag){
-				this->parseFeCompositeElement();
-			}else if(nsn.name == image_element::tag){
-				this->parseImageElement();
-			}else if(nsn.name == mask_element::tag){
-				this->parseMaskElement();
-			}else if(nsn.name == text_element::tag){
-				this->parseTextElement();
-			}else if(nsn.name == style_element::tag){
-				this->parse_style_element();
-			}else{
-				// unknown element, ignore
-				break;
+			switch(tags_map.get(nsn.name, svg_tag::unknown)){
+				case svg_tag::svg:
+					this->parseSvgElement();
+					return;
+				case svg_tag::symbol:
+					this->parseSymbolElement();
+					return;
+				case svg_tag::g:
+					this->parseGElement();
+					return;
+				case svg_tag::defs:
+					this->parseDefsElement();
+					return;
+				case svg_tag::use:
+					this->parseUseElement();
+					return;
+				case svg_tag::path:
+					this->parsePathElement();
+					return;
+				case svg_tag::linear_gradient:
+					this->parseLinearGradientElement();
+					return;
+				case svg_tag::radial_gradient:
+					this->parseRadialGradientElement();
+					return;
+				case svg_tag::stop:
+					this->parseGradientStopElement();
+					return;
+				case svg_tag::rect:
+					this->parseRectElement();
+					return;
+				case svg_tag::circle:
+					this->parseCircleElement();
+					return;
+				case svg_tag::ellipse:
+					this->parseEllipseElement();
+					return;
+				case svg_tag::line:
+					this->parseLineElement();
+					return;
+				case svg_tag::polyline:
+					this->parsePolylineElement();
+					return;
+				case svg_tag::polygon:
+					this->parsePolygonElement();
+					return;
+				case svg_tag::filter:
+					this->parseFilterElement();
+					return;
+				case svg_tag::fe_gaussian_blur:
+					this->parseFeGaussianBlurElement();
+					return;
+				case svg_tag::fe_color_matrix:
+					this->parseFeColorMatrixElement();
+					return;
+				case svg_tag::fe_blend:
+					this->parseFeBlendElement();
+					return;
+				case svg_tag::fe_composite:
+					this->parseFeCompositeElement();
+					return;
+				case svg_tag::image:
+					this->parseImageElement();
+					return;
+				case svg_tag::mask:
+					this->parseMaskElement();
+					return;
+				case svg_tag::text:
+					this->parseTextElement();
+					return;
+				case svg_tag::style:
+					this->parse_style_element();
+					return;
+				case svg_tag::unknown:
+					// unknown element, ignore
+					break;
 			}
-			return;
+			break;
 		default:
 			// unknown namespace, ignore
 			break;
@@ -151,7 +265,7 @@ void parser::parse_element(){
 	this->element_stack.push_back(nullptr);
 }
 
-parser::XmlNamespace_e parser::find_namespace(const std::string& ns){
+parser::XmlNamespace_e parser::find_namespace(std::string_view ns){
 	for(auto i = this->namespacesStack.rbegin(), e = this->namespacesStack.rend(); i != e; ++i){
 		auto iter = i->find(ns);
 		if(iter == i->end()){
@@ -163,23 +277,11 @@ parser::XmlNamespace_e parser::find_namespace(const std::string& ns){
 	return XmlNamespace_e::UNKNOWN;
 }
 
-const std::string* parser::findFlippedNamespace(XmlNamespace_e ns){
-	for(auto i = this->flippedNamespacesStack.rbegin(), e = this->flippedNamespacesStack.rend(); i != e; ++i){
-		auto iter = i->find(ns);
-		if(iter == i->end()){
-			continue;
-		}
-		ASSERT(ns == iter->first)
-		return &iter->second;
-	}
-	return nullptr;
-}
-
-parser::NamespaceNamePair parser::getNamespace(const std::string& xmlName){
+parser::NamespaceNamePair parser::getNamespace(std::string_view xmlName){
 	NamespaceNamePair ret;
 
 	auto colonIndex = xmlName.find_first_of(':');
-	if(colonIndex == std::string::npos){
+	if(colonIndex == std::string_view::npos){
 		ret.ns = this->defaultNamespaceStack.back();
 		ret.name = xmlName;
 		return ret;
@@ -188,36 +290,33 @@ parser::NamespaceNamePair parser::getNamespace(const std::string& xmlName){
 	ASSERT(xmlName.length() >= colonIndex + 1)
 
 	ret.ns = this->find_namespace(xmlName.substr(0, colonIndex));
-	ret.name = xmlName.substr(colonIndex + 1, xmlName.length() - 1 - colonIndex);
+	ret.name = xmlName.substr(colonIndex + 1);
 
 	return ret;
 }
 
-const std::string* parser::findAttribute(const std::string& name){
-	auto i = this->attributes.find(name);
-	if(i != this->attributes.end()){
-		return &i->second;
-	}
-	return nullptr;
-}
-
-const std::string* parser::findAttributeOfNamespace(XmlNamespace_e ns, const std::string& name){
-	if(this->defaultNamespaceStack.back() == ns){
-		if(auto a = this->findAttribute(name)){
-			return a;
+const std::string_view* parser::findAttributeOfNamespace(XmlNamespace_e ns, svg_attribute name){
+	ASSERT(name != svg_attribute::unknown)
+	const std::string_view* ret = nullptr;
+	for(auto& a : this->attributes){
+		if(a.interned_name != name || a.ns != ns){
+			continue;
 		}
-	}
-	
-	if(auto prefix = this->findFlippedNamespace(ns)){
-		if(auto a = this->findAttribute(*prefix + ":" + name)){
-			return a;
+		
+		// attribute without namespace prefix takes precedence
+		if(a.name.length() == a.qualified_name.length()){
+			return &a.value;
+		}
+		
+		if(!ret){
+			ret = &a.value;
 		}
 	}
-	return nullptr;
+	return ret;
 }
 
 void parser::fillElement(element& e){
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "id")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::id)){
 		e.id = *a;
 	}
 }
@@ -227,13 +326,17 @@ void parser::fillGradient(gradient& g){
 	this->fillReferencing(g);
 	this->fillStyleable(g);
 
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "spreadMethod")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::spread_method)){
 		g.spread_method_ = gradientStringToSpreadMethod(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "gradientTransform")){
-		g.transformations = transformable::parse(*a);
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::gradient_transform)){
+		if(this->lazy){
+			g.transformations.set_lazy(std::string(*a));
+		}else{
+			g.transformations = transformable::parse(*a);
+		}
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "gradientUnits")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::gradient_units)){
 		g.units = parse_coordinate_units(*a);
 	}
 }
@@ -241,24 +344,24 @@ void parser::fillGradient(gradient& g){
 void parser::fillRectangle(rectangle& r, const rectangle& defaultValues){
 	r = defaultValues;
 	
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "x")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::x)){
 		r.x = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "y")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::y)){
 		r.y = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "width")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::width)){
 		r.width = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "height")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::height)){
 		r.height = length::parse(*a);
 	}
 }
 
 void parser::fillReferencing(referencing& e){
-	auto a = this->findAttributeOfNamespace(XmlNamespace_e::XLINK, "href");
+	auto a = this->findAttributeOfNamespace(XmlNamespace_e::XLINK, svg_attribute::href);
 	if(!a){
-		a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "href");//in some SVG documents the svg namespace is used instead of xlink, though this is against SVG spec we allow to do so.
+		a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::href);//in some SVG documents the svg namespace is used instead of xlink, though this is against SVG spec we allow to do so.
 	}
 	if(a){
 		e.iri = *a;
@@ -275,22 +378,32 @@ void parser::fillStyleable(styleable& s){
 	ASSERT(s.styles.size() == 0)
 
 	for(auto& a : this->attributes){
-		auto nsn = this->getNamespace(a.first);
-		switch (nsn.ns){
+		switch (a.ns){
 			case XmlNamespace_e::SVG:
-				if(nsn.name == "style"){
-					s.styles = styleable::parse(a.second);
+				if(a.interned_name == svg_attribute::style){
+					if(this->lazy){
+						s.styles.set_lazy(std::string(a.value));
+					}else{
+						s.styles = styleable::parse(a.value);
+					}
 					break;
-				}else if(nsn.name == "class"){
-					s.classes = utki::split(a.second);
+				}else if(a.interned_name == svg_attribute::class_){
+					s.classes.clear();
+					for(string_parser p(a.value); !p.empty();){
+						p.skip_whitespaces();
+						auto c = p.read_word();
+						if(!c.empty()){
+							s.classes.emplace_back(c);
+						}
+					}
 					break;
 				}
 
 				// parse style attributes
 				{
-					style_property type = styleable::string_to_property(nsn.name);
+					style_property type = styleable::string_to_property(a.name);
 					if(type != style_property::unknown){
-						s.presentation_attributes[type] = styleable::parse_style_property_value(type, a.second);
+						s.presentation_attributes.set(type, styleable::parse_style_property_value(type, a.value));
 					}
 				}
 				break;
@@ -302,13 +415,17 @@ void parser::fillStyleable(styleable& s){
 
 void parser::fillTransformable(transformable& t){
 	ASSERT(t.transformations.size() == 0)
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "transform")){
-		t.transformations = transformable::parse(*a);
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::transform)){
+		if(this->lazy){
+			t.transformations.set_lazy(std::string(*a));
+		}else{
+			t.transformations = transformable::parse(*a);
+		}
 	}
 }
 
 void parser::fillViewBoxed(view_boxed& v){
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "viewBox")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::view_box)){
 		v.view_box = svg_element::parse_view_box(*a);
 	}
 }
@@ -322,7 +439,7 @@ void parser::fill_style(style_element& e){
 }
 
 void parser::fillAspectRatioed(aspect_ratioed& e){
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "preserveAspectRatio")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::preserve_aspect_ratio)){
 		e.preserve_aspect_ratio.parse(*a);
 	}
 }
@@ -352,7 +469,11 @@ void parser::addElement(std::unique_ptr<element> e){
 			parent->accept(c);
 		}
 		if(c.pointer){
-			c.pointer->children.push_back(std::move(e));
+			if(this->streaming_handler){
+				this->streamed_elements.push_back(std::move(e));
+			}else{
+				c.pointer->children.push_back(std::move(e));
+			}
 		}else{
 			elem = nullptr;
 		}
@@ -360,21 +481,48 @@ void parser::addElement(std::unique_ptr<element> e){
 	this->element_stack.push_back(elem);
 }
 
+namespace{
+// Element allocated from memory resource. Its memory is not returned to the memory resource
+// when the element is deleted, it is reclaimed when the memory resource releases all its memory.
+// Since element has virtual destructor, deleting any element calls the deallocation function
+// of its actual class, so it is the class of the element which tells where its memory is from.
+template <class T> class resource_element final : public T{
+public:
+	static void operator delete(void* p)noexcept{}
+};
+}
+
+template <class T> std::unique_ptr<T> parser::make_element(){
+	if(!this->element_resource){
+		return std::make_unique<T>();
+	}
+
+	typedef resource_element<T> type;
+
+	auto mem = this->element_resource->allocate(sizeof(type), alignof(type));
+	try{
+		return std::unique_ptr<T>(new(mem) type());
+	}catch(...){
+		this->element_resource->deallocate(mem, sizeof(type), alignof(type));
+		throw;
+	}
+}
+
 void parser::parseCircleElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == circle_element::tag)
 
-	auto ret = std::make_unique<circle_element>();
+	auto ret = this->make_element<circle_element>();
 
 	this->fillShape(*ret);
 
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "cx")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::cx)){
 		ret->cx = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "cy")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::cy)){
 		ret->cy = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "r")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::r)){
 		ret->r = length::parse(*a);
 	}
 
@@ -385,7 +533,7 @@ void parser::parseDefsElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == defs_element::tag)
 
-	auto ret = std::make_unique<defs_element>();
+	auto ret = this->make_element<defs_element>();
 
 	this->fillElement(*ret);
 	this->fillTransformable(*ret);
@@ -398,17 +546,17 @@ void parser::parseMaskElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == mask_element::tag)
 
-	auto ret = std::make_unique<mask_element>();
+	auto ret = this->make_element<mask_element>();
 
 	this->fillElement(*ret);
 	this->fillRectangle(*ret);
 	this->fillStyleable(*ret);
 
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "maskUnits")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::mask_units)){
 		ret->mask_units = parse_coordinate_units(*a);
 	}
 	
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "maskContentUnits")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::mask_content_units)){
 		ret->mask_content_units = parse_coordinate_units(*a);
 	}
 	
@@ -419,7 +567,7 @@ void parser::parseTextElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == text_element::tag)
 
-	auto ret = std::make_unique<text_element>();
+	auto ret = this->make_element<text_element>();
 
 	this->fillElement(*ret);
 	this->fillStyleable(*ret);
@@ -435,7 +583,7 @@ void parser::parse_style_element(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == style_element::tag)
 
-	auto ret = std::make_unique<style_element>();
+	auto ret = this->make_element<style_element>();
 
 	this->fillElement(*ret);
 	this->fill_style(*ret);
@@ -449,20 +597,20 @@ void parser::parseEllipseElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == ellipse_element::tag)
 
-	auto ret = std::make_unique<ellipse_element>();
+	auto ret = this->make_element<ellipse_element>();
 
 	this->fillShape(*ret);
 
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "cx")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::cx)){
 		ret->cx = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "cy")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::cy)){
 		ret->cy = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "rx")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::rx)){
 		ret->rx = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "ry")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::ry)){
 		ret->ry = length::parse(*a);
 	}
 
@@ -473,7 +621,7 @@ void parser::parseGElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == g_element::tag)
 
-	auto ret = std::make_unique<g_element>();
+	auto ret = this->make_element<g_element>();
 
 	this->fillElement(*ret);
 	this->fillTransformable(*ret);
@@ -486,14 +634,18 @@ void parser::parseGradientStopElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == gradient::stop_element::tag)
 
-	auto ret = std::make_unique<gradient::stop_element>();
+	auto ret = this->make_element<gradient::stop_element>();
 	
 	this->fillStyleable(*ret);
 	
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "offset")){
-		std::istringstream s(*a);
-		s >> ret->offset;
-		if(!s.eof() && s.peek() == '%'){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::offset)){
+		string_parser p(*a);
+		try{
+			ret->offset = p.read_real();
+		}catch(std::invalid_argument&){
+			ret->offset = 0;
+		}
+		if(!p.empty() && p.peek_char() == '%'){
 			ret->offset /= 100;
 		}
 	}
@@ -505,20 +657,20 @@ void parser::parseLineElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == line_element::tag)
 
-	auto ret = std::make_unique<line_element>();
+	auto ret = this->make_element<line_element>();
 
 	this->fillShape(*ret);
 	
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "x1")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::x1)){
 		ret->x1 = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "y1")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::y1)){
 		ret->y1 = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "x2")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::x2)){
 		ret->x2 = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "y2")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::y2)){
 		ret->y2 = length::parse(*a);
 	}
 
@@ -530,7 +682,7 @@ void parser::parseFilterElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == filter_element::tag)
 	
-	auto ret = std::make_unique<filter_element>();
+	auto ret = this->make_element<filter_element>();
 	
 	this->fillElement(*ret);
 	this->fillStyleable(*ret);
@@ -545,10 +697,10 @@ void parser::parseFilterElement(){
 		);
 	this->fillReferencing(*ret);
 	
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "filterUnits")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::filter_units)){
 		ret->filter_units = svgdom::parse_coordinate_units(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "primitiveUnits")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::primitive_units)){
 		ret->primitive_units = svgdom::parse_coordinate_units(*a);
 	}
 	
@@ -560,19 +712,19 @@ void parser::fillFilterPrimitive(filter_primitive& p){
 	this->fillRectangle(p);
 	this->fillStyleable(p);
 
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "result")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::result)){
 		p.result = *a;
 	}
 }
 
 void parser::fillInputable(inputable& p){
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "in")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::in)){
 		p.in = *a;
 	}
 }
 
 void parser::fillSecondInputable(second_inputable& p){
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "in2")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::in2)){
 		p.in2 = *a;
 	}
 }
@@ -581,12 +733,12 @@ void parser::parseFeGaussianBlurElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == fe_gaussian_blur_element::tag)
 	
-	auto ret = std::make_unique<fe_gaussian_blur_element>();
+	auto ret = this->make_element<fe_gaussian_blur_element>();
 	
 	this->fillFilterPrimitive(*ret);
 	this->fillInputable(*ret);
 
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "stdDeviation")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::std_deviation)){
 		ret->std_deviation = parse_number_and_optional_number(*a, {{-1, -1}});
 	}
 	
@@ -597,12 +749,12 @@ void parser::parseFeColorMatrixElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == fe_color_matrix_element::tag)
 	
-	auto ret = std::make_unique<fe_color_matrix_element>();
+	auto ret = this->make_element<fe_color_matrix_element>();
 	
 	this->fillFilterPrimitive(*ret);
 	this->fillInputable(*ret);
 	
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "type")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::type)){
 		if(*a == "saturate"){
 			ret->type_ = fe_color_matrix_element::type::saturate;
 		}else if(*a == "hueRotate"){
@@ -614,35 +766,32 @@ void parser::parseFeColorMatrixElement(){
 		}
 	}
 	
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "values")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::values)){
 		switch(ret->type_){
 			default:
 				ASSERT(false) // should never get here, MATRIX should always be the default value
 				break;
 			case fe_color_matrix_element::type::matrix:
 				// 20 values expected
-				{
-					std::istringstream ss(*a);
+				try{
+					string_parser p(*a);
 					
-					for(unsigned i = 0; i != 20; ++i){
-						ret->values[i] = read_in_real(ss);
-						if(ss.fail()){
-							throw malformed_svg_error("malformed 'values' string of 'feColorMatrix' element");
-						}
-						skip_whitespaces_and_comma(ss);
+					for(auto& v : ret->values){
+						v = p.read_real();
+						p.skip_whitespaces_and_comma();
 					}
+				}catch(std::invalid_argument&){
+					throw malformed_svg_error("malformed 'values' string of 'feColorMatrix' element");
 				}
 				break;
 			case fe_color_matrix_element::type::hue_rotate:
 				// fall-through
 			case fe_color_matrix_element::type::saturate:
 				// one value is expected
-				{
-					std::istringstream ss(*a);
-					ret->values[0] = read_in_real(ss);
-					if(ss.fail()){
-						throw malformed_svg_error("malformed 'values' string of 'feColorMatrix' element");
-					}
+				try{
+					ret->values[0] = string_parser(*a).read_real();
+				}catch(std::invalid_argument&){
+					throw malformed_svg_error("malformed 'values' string of 'feColorMatrix' element");
 				}
 				break;
 			case fe_color_matrix_element::type::luminance_to_alpha:
@@ -658,13 +807,13 @@ void parser::parseFeBlendElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == fe_blend_element::tag)
 	
-	auto ret = std::make_unique<fe_blend_element>();
+	auto ret = this->make_element<fe_blend_element>();
 	
 	this->fillFilterPrimitive(*ret);
 	this->fillInputable(*ret);
 	this->fillSecondInputable(*ret);
 	
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "mode")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::mode)){
 		if(*a == "normal"){
 			ret->mode_ = fe_blend_element::mode::normal;
 		}else if(*a == "multiply"){
@@ -685,13 +834,13 @@ void parser::parseFeCompositeElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == fe_composite_element::tag)
 	
-	auto ret = std::make_unique<fe_composite_element>();
+	auto ret = this->make_element<fe_composite_element>();
 	
 	this->fillFilterPrimitive(*ret);
 	this->fillInputable(*ret);
 	this->fillSecondInputable(*ret);
 	
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "operator")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::operator_)){
 		if(*a == "over"){
 			ret->operator__ = fe_composite_element::operator_::over;
 		}else if(*a == "in"){
@@ -707,20 +856,20 @@ void parser::parseFeCompositeElement(){
 		}
 	}
 	
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "k1")){
-		ret->k1 = real(std::strtod(a->c_str(), nullptr));
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::k1)){
+		ret->k1 = parse_real_or_zero(*a);
 	}
 	
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "k2")){
-		ret->k2 = real(std::strtod(a->c_str(), nullptr));
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::k2)){
+		ret->k2 = parse_real_or_zero(*a);
 	}
 	
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "k3")){
-		ret->k3 = real(std::strtod(a->c_str(), nullptr));
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::k3)){
+		ret->k3 = parse_real_or_zero(*a);
 	}
 	
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "k4")){
-		ret->k4 = real(std::strtod(a->c_str(), nullptr));
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::k4)){
+		ret->k4 = parse_real_or_zero(*a);
 	}
 	
 	this->addElement(std::move(ret));
@@ -730,20 +879,20 @@ void parser::parseLinearGradientElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == linear_gradient_element::tag)
 
-	auto ret = std::make_unique<linear_gradient_element>();
+	auto ret = this->make_element<linear_gradient_element>();
 
 	this->fillGradient(*ret);
 
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "x1")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::x1)){
 		ret->x1 = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "y1")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::y1)){
 		ret->y1 = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "x2")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::x2)){
 		ret->x2 = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "y2")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::y2)){
 		ret->y2 = length::parse(*a);
 	}
 
@@ -754,12 +903,16 @@ void parser::parsePathElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == path_element::tag)
 
-	auto ret = std::make_unique<path_element>();
+	auto ret = this->make_element<path_element>();
 
 	this->fillShape(*ret);
 
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "d")){
-		ret->path = path_element::parse(*a);
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::d)){
+		if(this->lazy){
+			ret->path.set_lazy(std::string(*a));
+		}else{
+			ret->path = path_element::parse(*a);
+		}
 	}
 	
 	this->addElement(std::move(ret));
@@ -769,11 +922,11 @@ void parser::parsePolygonElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == polygon_element::tag)
 
-	auto ret = std::make_unique<polygon_element>();
+	auto ret = this->make_element<polygon_element>();
 
 	this->fillShape(*ret);
 
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "points")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::points)){
 		ret->points = ret->parse(*a);
 	}
 	
@@ -784,11 +937,11 @@ void parser::parsePolylineElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == polyline_element::tag)
 
-	auto ret = std::make_unique<polyline_element>();
+	auto ret = this->make_element<polyline_element>();
 
 	this->fillShape(*ret);
 
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "points")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::points)){
 		ret->points = ret->parse(*a);
 	}
 	
@@ -799,23 +952,23 @@ void parser::parseRadialGradientElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == radial_gradient_element::tag)
 
-	auto ret = std::make_unique<radial_gradient_element>();
+	auto ret = this->make_element<radial_gradient_element>();
 
 	this->fillGradient(*ret);
 
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "cx")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::cx)){
 		ret->cx = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "cy")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::cy)){
 		ret->cy = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "r")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::r)){
 		ret->r = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "fx")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::fx)){
 		ret->fx = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "fy")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::fy)){
 		ret->fy = length::parse(*a);
 	}
 
@@ -826,15 +979,15 @@ void parser::parseRectElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == rect_element::tag)
 
-	auto ret = std::make_unique<rect_element>();
+	auto ret = this->make_element<rect_element>();
 
 	this->fillShape(*ret);
 	this->fillRectangle(*ret, rect_element::rectangle_default_values());
 
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "rx")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::rx)){
 		ret->rx = length::parse(*a);
 	}
-	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, "ry")){
+	if(auto a = this->findAttributeOfNamespace(XmlNamespace_e::SVG, svg_attribute::ry)){
 		ret->ry = length::parse(*a);
 	}
 
@@ -845,7 +998,7 @@ void parser::parseSvgElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == svg_element::tag)
 
-	auto ret = std::make_unique<svg_element>();
+	auto ret = this->make_element<svg_element>();
 
 	this->fillElement(*ret);
 	this->fillStyleable(*ret);
@@ -860,7 +1013,7 @@ void parser::parseImageElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == image_element::tag)
 
-	auto ret = std::make_unique<image_element>();
+	auto ret = this->make_element<image_element>();
 
 	this->fillElement(*ret);
 	this->fillStyleable(*ret);
@@ -878,7 +1031,7 @@ void parser::parseSymbolElement(){
 
 	//		TRACE(<< "parseSymbolElement():" << std::endl)
 
-	auto ret = std::make_unique<symbol_element>();
+	auto ret = this->make_element<symbol_element>();
 
 	this->fillElement(*ret);
 	this->fillStyleable(*ret);
@@ -892,7 +1045,7 @@ void parser::parseUseElement(){
 	ASSERT(this->getNamespace(this->cur_element).ns == XmlNamespace_e::SVG)
 	ASSERT(this->getNamespace(this->cur_element).name == use_element::tag)
 
-	auto ret = std::make_unique<use_element>();
+	auto ret = this->make_element<use_element>();
 
 	this->fillElement(*ret);
 	this->fillTransformable(*ret);
@@ -904,27 +1057,67 @@ void parser::parseUseElement(){
 }
 
 void parser::on_element_start(utki::span<const char> name){
-	this->cur_element = utki::make_string(name);
+	this->cur_element.assign(name.begin(), name.end());
 }
 
 void parser::on_element_end(utki::span<const char> name){
 	this->popNamespaces();
+	
+	if(this->streaming_handler){
+		ASSERT(!this->element_stack.empty())
+		if(auto e = this->element_stack.back()){
+			this->streaming_handler(*e, utki::make_span(this->element_stack.data(), this->element_stack.size() - 1));
+			if(this->element_stack.size() != 1){
+				ASSERT(!this->streamed_elements.empty())
+				ASSERT(this->streamed_elements.back().get() == e)
+				this->streamed_elements.pop_back();
+			}
+		}
+	}
+	
 	this->element_stack.pop_back();
 }
 
 void parser::on_attribute_parsed(utki::span<const char> name, utki::span<const char> value){
 	ASSERT(this->cur_element.length() != 0)
-	this->attributes[utki::make_string(name)] = utki::make_string(value);
+	// the name and value spans are only valid during this call, so copy them to the buffer
+	this->attributes_buffer.insert(this->attributes_buffer.end(), name.begin(), name.end());
+	this->attributes_buffer.insert(this->attributes_buffer.end(), value.begin(), value.end());
+	
+	attribute a;
+	a.name_length = name.size();
+	a.value_length = value.size();
+	this->attributes.push_back(a);
 }
 
 void parser::on_attributes_end(bool is_empty_element){
 //	TRACE(<< "this->cur_element = " << this->cur_element << std::endl)
 //	TRACE(<< "this->element_stack.size() = " << this->element_stack.size() << std::endl)
+	
+	// attributes buffer will not change anymore, so set up the views into it
+	{
+		auto p = this->attributes_buffer.data();
+		for(auto& a : this->attributes){
+			a.qualified_name = std::string_view(p, a.name_length);
+			p += a.name_length;
+			a.value = std::string_view(p, a.value_length);
+			p += a.value_length;
+		}
+	}
+	
 	this->pushNamespaces();
+	
+	for(auto& a : this->attributes){
+		auto nsn = this->getNamespace(a.qualified_name);
+		a.ns = nsn.ns;
+		a.name = nsn.name;
+		a.interned_name = attributes_map.get(a.name, svg_attribute::unknown);
+	}
 
 	this->parse_element();
 
 	this->attributes.clear();
+	this->attributes_buffer.clear();
 	this->cur_element.clear();
 }
 
@@ -956,6 +1149,7 @@ public:
 					return ret;
 				}
 			));
+		e.selector_index = css_selector_index(e.css);
 	}
 };
 }
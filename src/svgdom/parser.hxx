@@ -3,6 +3,9 @@
 #include <map>
 #include <vector>
 #include <memory>
+#include <string_view>
+#include <functional>
+#include <memory_resource>
 
 #include <mikroxml/mikroxml.hpp>
 
@@ -21,6 +24,83 @@
 
 namespace svgdom{
 
+enum class svg_tag{
+	unknown,
+	svg,
+	symbol,
+	g,
+	defs,
+	use,
+	path,
+	linear_gradient,
+	radial_gradient,
+	stop,
+	rect,
+	circle,
+	ellipse,
+	line,
+	polyline,
+	polygon,
+	filter,
+	fe_gaussian_blur,
+	fe_color_matrix,
+	fe_blend,
+	fe_composite,
+	image,
+	mask,
+	text,
+	style
+};
+
+// attributes known to the parser
+enum class svg_attribute{
+	unknown,
+	class_,
+	cx,
+	cy,
+	d,
+	filter_units,
+	fx,
+	fy,
+	gradient_transform,
+	gradient_units,
+	height,
+	href,
+	id,
+	in,
+	in2,
+	k1,
+	k2,
+	k3,
+	k4,
+	mask_content_units,
+	mask_units,
+	mode,
+	offset,
+	operator_,
+	points,
+	preserve_aspect_ratio,
+	primitive_units,
+	r,
+	result,
+	rx,
+	ry,
+	spread_method,
+	std_deviation,
+	style,
+	transform,
+	type,
+	values,
+	view_box,
+	width,
+	x,
+	x1,
+	x2,
+	y,
+	y1,
+	y2
+};
+
 class parser : public mikroxml::parser{
 	enum class XmlNamespace_e{
 		ENUM_FIRST,
@@ -32,38 +112,52 @@ class parser : public mikroxml::parser{
 	};
 	
 	std::vector<
-			std::map<std::string, XmlNamespace_e>
+			std::map<std::string, XmlNamespace_e, std::less<>>
 		> namespacesStack;
-	std::vector<
-			std::map<XmlNamespace_e, std::string>
-		> flippedNamespacesStack;
 	
 	std::vector<XmlNamespace_e> defaultNamespaceStack;
 	
 	
-	XmlNamespace_e find_namespace(const std::string& ns);
-	const std::string* findFlippedNamespace(XmlNamespace_e ns);
+	XmlNamespace_e find_namespace(std::string_view ns);
 	
 	struct NamespaceNamePair{
 		XmlNamespace_e ns;
-		std::string name;
+		std::string_view name;
 	};
 	
-	NamespaceNamePair getNamespace(const std::string& xmlName);
-	
-	const std::string* findAttribute(const std::string& name);
+	NamespaceNamePair getNamespace(std::string_view xmlName);
 	
-	const std::string* findAttributeOfNamespace(XmlNamespace_e ns, const std::string& name);
+	const std::string_view* findAttributeOfNamespace(XmlNamespace_e ns, svg_attribute name);
 
 	void pushNamespaces();
 	void popNamespaces();
 	
 	std::string cur_element;
-	std::map<std::string, std::string> attributes;
+	
+	struct attribute{
+		// lengths of the qualified name and value, which are stored one after another in the attributes_buffer
+		size_t name_length;
+		size_t value_length;
+		
+		// following fields are set when all attributes of the element are parsed
+		std::string_view qualified_name;
+		std::string_view value;
+		XmlNamespace_e ns;
+		std::string_view name; // local name, without namespace prefix
+		svg_attribute interned_name;
+	};
+	
+	// Attributes of the current element. Buffers are cleared, but not freed, after each element,
+	// so that parsing of subsequent elements does not allocate memory for attributes.
+	std::vector<attribute> attributes;
+	std::vector<char> attributes_buffer;
 	
 	std::unique_ptr<svg_element> svg; // root svg element
 	std::vector<element*> element_stack;
 	
+	// in streaming mode holds not yet ended elements, except root, instead of adding them to parents
+	std::vector<std::unique_ptr<element>> streamed_elements;
+	
 	void addElement(std::unique_ptr<element> e);
 	
 	void on_element_start(utki::span<const char> name) override;
@@ -94,6 +188,8 @@ class parser : public mikroxml::parser{
 	void fillSecondInputable(second_inputable& p);
 	void fillTextPositioning(text_positioning& p);
 	void fill_style(style_element& e);
+
+	template <class T> std::unique_ptr<T> make_element();
 	
 	void parseGradientStopElement();
 	void parseSvgElement();
@@ -122,6 +218,26 @@ class parser : public mikroxml::parser{
 	
 	void parse_element();
 public:
+	/**
+	 * @brief Streaming mode handler.
+	 * If set, the parser does not build the document tree. Instead, each element is passed to the handler
+	 * when its end tag is parsed and is deleted right after that.
+	 */
+	std::function<void(element& e, utki::span<element* const> ancestors)> streaming_handler;
+
+	/**
+	 * @brief Lazy mode flag.
+	 * If set, path data, transformations and style attributes are not parsed during loading,
+	 * instead, their raw text is stored in the elements to be parsed on first access.
+	 */
+	bool lazy = false;
+
+	/**
+	 * @brief Memory resource to allocate element objects from.
+	 * If not set, the elements are allocated from the heap.
+	 */
+	std::pmr::memory_resource* element_resource = nullptr;
+	
 	std::unique_ptr<svg_element> get_dom();
 };
 
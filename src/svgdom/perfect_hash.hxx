@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+#include <stdexcept>
+#include <cstdint>
+
+namespace svgdom{
+
+constexpr uint32_t perfect_hash_function(std::string_view str, uint32_t seed)noexcept{
+	// FNV-1a with seeded offset basis, followed by murmur3 finalizer for better avalanche
+	uint32_t h = uint32_t(2166136261u ^ uint32_t(seed * 0x9e3779b9u));
+	for(char c : str){
+		h ^= uint8_t(c);
+		h = uint32_t(h * 16777619u);
+	}
+	h ^= h >> 16;
+	h = uint32_t(h * 0x85ebca6bu);
+	h ^= h >> 13;
+	h = uint32_t(h * 0xc2b2ae35u);
+	h ^= h >> 16;
+	return h;
+}
+
+template <typename T_value> struct perfect_hash_entry{
+	std::string_view key;
+	T_value value;
+};
+
+/**
+ * @brief Constant string to value map with perfect hashing.
+ * The hash table is built at compile time using "hash, displace" method:
+ * keys are distributed to buckets by one hash function, then for each bucket
+ * a seed is searched for the second hash function such that all keys of the
+ * bucket land to free slots of the table. Lookup costs two hash calculations
+ * and one string comparison, no matter how many keys there are.
+ * Keys must be unique and non-empty, otherwise construction fails.
+ */
+template <typename T_value, size_t N> class perfect_hash_map{
+	static_assert(N != 0, "perfect_hash_map must have at least one entry");
+
+	static constexpr size_t calc_table_size()noexcept{
+		size_t ret = 1;
+		while(ret < 2 * N){
+			ret <<= 1;
+		}
+		return ret;
+	}
+
+	static constexpr size_t table_size = calc_table_size();
+	static constexpr size_t num_buckets = (N + 1) / 2;
+
+	std::array<perfect_hash_entry<T_value>, table_size> table{};
+	std::array<uint32_t, num_buckets> seeds{};
+
+	static constexpr size_t bucket_of(std::string_view key)noexcept{
+		return perfect_hash_function(key, 0) % num_buckets;
+	}
+
+	static constexpr size_t slot_of(std::string_view key, uint32_t seed)noexcept{
+		return perfect_hash_function(key, seed) & (table_size - 1);
+	}
+
+public:
+	constexpr perfect_hash_map(const perfect_hash_entry<T_value> (&entries)[N]){
+		std::array<size_t, N> buckets{};
+		std::array<size_t, num_buckets> bucket_sizes{};
+		size_t max_bucket_size = 0;
+		for(size_t i = 0; i != N; ++i){
+			if(entries[i].key.empty()){
+				throw std::logic_error("perfect_hash_map: empty key");
+			}
+			buckets[i] = bucket_of(entries[i].key);
+			++bucket_sizes[buckets[i]];
+			if(bucket_sizes[buckets[i]] > max_bucket_size){
+				max_bucket_size = bucket_sizes[buckets[i]];
+			}
+		}
+
+		std::array<bool, table_size> occupied{};
+
+		// place the biggest buckets first, while the table is still mostly empty
+		for(size_t size = max_bucket_size; size != 0; --size){
+			for(size_t b = 0; b != num_buckets; ++b){
+				if(bucket_sizes[b] != size){
+					continue;
+				}
+
+				std::array<size_t, N> keys{};
+				size_t num_keys = 0;
+				for(size_t i = 0; i != N; ++i){
+					if(buckets[i] == b){
+						keys[num_keys++] = i;
+					}
+				}
+
+				for(uint32_t seed = 1;; ++seed){
+					constexpr uint32_t max_seed = 0x10000;
+					if(seed == max_seed){
+						throw std::logic_error("perfect_hash_map: could not place keys, duplicate key?");
+					}
+
+					std::array<size_t, N> slots{};
+					bool fits = true;
+					for(size_t k = 0; k != num_keys && fits; ++k){
+						slots[k] = slot_of(entries[keys[k]].key, seed);
+						if(occupied[slots[k]]){
+							fits = false;
+						}
+						for(size_t j = 0; j != k && fits; ++j){
+							if(slots[j] == slots[k]){
+								fits = false;
+							}
+						}
+					}
+					if(!fits){
+						continue;
+					}
+
+					for(size_t k = 0; k != num_keys; ++k){
+						occupied[slots[k]] = true;
+						this->table[slots[k]] = entries[keys[k]];
+					}
+					this->seeds[b] = seed;
+					break;
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Look up value by key.
+	 * @param key - key to look up.
+	 * @param default_value - value to return if the key is not in the map.
+	 * @return value corresponding to the key, or the default value.
+	 */
+	constexpr T_value get(std::string_view key, T_value default_value)const noexcept{
+		if(key.empty()){
+			return default_value;
+		}
+		const auto& e = this->table[slot_of(key, this->seeds[bucket_of(key)])];
+		if(e.key != key){
+			return default_value;
+		}
+		return e.value;
+	}
+};
+
+template <typename T_value, size_t N>
+constexpr perfect_hash_map<T_value, N> make_perfect_hash_map(const perfect_hash_entry<T_value> (&entries)[N]){
+	return perfect_hash_map<T_value, N>(entries);
+}
+
+/**
+ * @brief Make array of keys indexed by values.
+ * Used for mapping enumeration values back to strings at compile time.
+ * Values must be convertible to index less than N_values. Indices which have no
+ * corresponding key get empty string. If several keys have the same value, the first one is used.
+ * @param entries - key-value pairs.
+ * @return array of keys indexed by values.
+ */
+template <size_t N_values, typename T_value, size_t N>
+constexpr std::array<std::string_view, N_values> make_key_array(const perfect_hash_entry<T_value> (&entries)[N]){
+	std::array<std::string_view, N_values> ret{};
+	for(size_t i = 0; i != N; ++i){
+		auto index = size_t(entries[i].value);
+		if(index >= N_values){
+			throw std::logic_error("make_key_array: value is out of range");
+		}
+		if(ret[index].empty()){
+			ret[index] = entries[i].key;
+		}
+	}
+	return ret;
+}
+
+}
@@ -0,0 +1,898 @@
+#include "snapshot.hpp"
+
+#include <cstddef>
+
+#include "snapshot_format.hxx"
+#include "visitor.hpp"
+
+using namespace svgdom;
+
+void snapshot_output::write_strings(const std::vector<std::string>& strs){
+	this->write(uint32_t(strs.size()));
+	for(auto& s : strs){
+		this->write_string(s);
+	}
+}
+
+void snapshot_output::write_style_map(const style_map& m){
+	this->write(uint32_t(m.size()));
+	for(auto& v : m){
+		this->write(uint8_t(v.first));
+		this->write_style_value(v.second);
+	}
+}
+
+std::vector<std::string> snapshot_input::read_strings(){
+	auto size = this->read<uint32_t>();
+	std::vector<std::string> ret;
+	for(uint32_t i = 0; i != size; ++i){
+		ret.emplace_back(this->read_string());
+	}
+	return ret;
+}
+
+void snapshot_input::read_style_map(style_map& m){
+	m.clear();
+	auto size = this->read<uint32_t>();
+	for(uint32_t i = 0; i != size; ++i){
+		auto p = this->read_style_property();
+		m.set(p, this->read_style_value());
+	}
+}
+
+uint64_t svgdom::make_snapshot_source_key(utki::span<const char> svg)noexcept{
+	// 64 bit FNV-1a
+	uint64_t h = 14695981039346656037ull;
+	for(auto c : svg){
+		h ^= uint8_t(c);
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+namespace{
+class snapshot_writer : public const_visitor{
+	size_t cur_record = 0;
+
+	size_t begin_record(element_type type, const element& e){
+		ASSERT(this->out.pos() % snapshot_record_alignment == 0)
+		this->cur_record = this->out.pos();
+		snapshot_record r{};
+		r.type = type;
+		this->out.write(r); // placeholder, offsets are written as the attributes and children are written
+		this->out.write_string(e.id);
+		return this->cur_record;
+	}
+
+	void end_record(size_t record){
+		this->out.align(snapshot_record_alignment);
+		auto size = uint32_t(this->out.pos() - record);
+		this->out.write_at(record + offsetof(snapshot_record, size), size);
+		uint32_t children;
+		std::memcpy(&children, this->out.buf.data() + record + offsetof(snapshot_record, children), sizeof(children));
+		if(children == 0){
+			this->out.write_at(record + offsetof(snapshot_record, children), size);
+		}
+	}
+
+	// store offset of the current position in the given field of current record header
+	void mark(size_t field_offset){
+		this->out.write_at(this->cur_record + field_offset, uint32_t(this->out.pos() - this->cur_record));
+	}
+
+	void write_children(size_t record, const container& c){
+		this->out.align(snapshot_record_alignment);
+		this->mark(offsetof(snapshot_record, children));
+		this->relay_accept(c);
+		this->cur_record = record;
+	}
+
+	void write_transformable(const transformable& e){
+		this->mark(offsetof(snapshot_record, transformable));
+		this->out.write(uint32_t(e.transformations.size()));
+		for(auto& t : e.transformations){
+			this->out.write_value(t.type_);
+			// only write the values which are used by the transformation type, others are not initialized
+			switch(t.type_){
+				case transformable::transformation::type::matrix:
+					this->out.write(t.a);
+					this->out.write(t.b);
+					this->out.write(t.c);
+					this->out.write(t.d);
+					this->out.write(t.e);
+					this->out.write(t.f);
+					break;
+				case transformable::transformation::type::translate:
+				case transformable::transformation::type::scale:
+					this->out.write(t.x);
+					this->out.write(t.y);
+					break;
+				case transformable::transformation::type::rotate:
+					this->out.write(t.angle);
+					this->out.write(t.x);
+					this->out.write(t.y);
+					break;
+				case transformable::transformation::type::skewx:
+				case transformable::transformation::type::skewy:
+					this->out.write(t.angle);
+					break;
+			}
+		}
+	}
+
+	void write_styleable(const styleable& e){
+		this->mark(offsetof(snapshot_record, styleable));
+		this->out.write_style_map(e.styles);
+		this->out.write_style_map(e.presentation_attributes);
+		this->out.write_strings(e.classes);
+	}
+
+	void write_rectangle(const rectangle& e){
+		this->mark(offsetof(snapshot_record, rectangle));
+		this->out.write_length(e.x);
+		this->out.write_length(e.y);
+		this->out.write_length(e.width);
+		this->out.write_length(e.height);
+	}
+
+	void write_referencing(const referencing& e){
+		this->mark(offsetof(snapshot_record, referencing));
+		this->out.write_string(e.iri);
+	}
+
+	void write_view_boxed(const view_boxed& e){
+		this->mark(offsetof(snapshot_record, view_boxed));
+		for(auto v : e.view_box){
+			this->out.write(v);
+		}
+	}
+
+	void write_aspect_ratioed(const aspect_ratioed& e){
+		this->out.write_value(e.preserve_aspect_ratio.preserve);
+		this->out.write(uint8_t(e.preserve_aspect_ratio.defer));
+		this->out.write(uint8_t(e.preserve_aspect_ratio.slice));
+	}
+
+	void write_shape(const shape& e){
+		this->write_transformable(e);
+		this->write_styleable(e);
+	}
+
+	void write_points(const polyline_shape& e){
+		this->out.write(uint32_t(e.points.size() * 2));
+		this->out.align(alignof(real));
+		for(auto& p : e.points){
+			this->out.write(p.x());
+			this->out.write(p.y());
+		}
+	}
+
+	void write_gradient(const gradient& e){
+		this->write_referencing(e);
+		this->write_transformable(e);
+		this->write_styleable(e);
+		this->out.write_value(e.spread_method_);
+		this->out.write_value(e.units);
+	}
+
+	void write_filter_primitive(const filter_primitive& e){
+		this->write_rectangle(e);
+		this->write_styleable(e);
+		this->out.write_string(e.result);
+	}
+
+	void write_css(const cssdom::document& css){
+		this->out.write(uint32_t(css.styles.size()));
+		for(auto& s : css.styles){
+			this->out.write(uint32_t(s.selectors.size()));
+			for(auto& sel : s.selectors){
+				this->out.write_string(sel.tag);
+				this->out.write_string(sel.id);
+				this->out.write_strings(sel.classes);
+				this->out.write_value(sel.combinator);
+			}
+			this->out.write(uint32_t(s.properties.size()));
+			for(auto& p : s.properties){
+				this->out.write(p.id);
+				this->out.write(uint8_t(p.is_important));
+				if(p.value){
+					this->out.write(uint8_t(1));
+					this->out.write_style_value(static_cast<const style_element::css_style_value&>(*p.value).value);
+				}else{
+					this->out.write(uint8_t(0));
+				}
+			}
+			this->out.write(s.specificity);
+		}
+	}
+
+public:
+	snapshot_output out;
+
+	void visit(const path_element& e)override{
+		auto record = this->begin_record(element_type::path, e);
+		this->write_shape(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->out.write(uint32_t(e.path.size()));
+		this->out.write_bytes(e.path.commands().data(), e.path.commands().size());
+		this->out.write_reals(e.path.coordinates());
+		this->end_record(record);
+	}
+
+	void visit(const rect_element& e)override{
+		auto record = this->begin_record(element_type::rect, e);
+		this->write_shape(e);
+		this->write_rectangle(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->out.write_length(e.rx);
+		this->out.write_length(e.ry);
+		this->end_record(record);
+	}
+
+	void visit(const circle_element& e)override{
+		auto record = this->begin_record(element_type::circle, e);
+		this->write_shape(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->out.write_length(e.cx);
+		this->out.write_length(e.cy);
+		this->out.write_length(e.r);
+		this->end_record(record);
+	}
+
+	void visit(const ellipse_element& e)override{
+		auto record = this->begin_record(element_type::ellipse, e);
+		this->write_shape(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->out.write_length(e.cx);
+		this->out.write_length(e.cy);
+		this->out.write_length(e.rx);
+		this->out.write_length(e.ry);
+		this->end_record(record);
+	}
+
+	void visit(const line_element& e)override{
+		auto record = this->begin_record(element_type::line, e);
+		this->write_shape(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->out.write_length(e.x1);
+		this->out.write_length(e.y1);
+		this->out.write_length(e.x2);
+		this->out.write_length(e.y2);
+		this->end_record(record);
+	}
+
+	void visit(const polyline_element& e)override{
+		auto record = this->begin_record(element_type::polyline, e);
+		this->write_shape(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->write_points(e);
+		this->end_record(record);
+	}
+
+	void visit(const polygon_element& e)override{
+		auto record = this->begin_record(element_type::polygon, e);
+		this->write_shape(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->write_points(e);
+		this->end_record(record);
+	}
+
+	void visit(const g_element& e)override{
+		auto record = this->begin_record(element_type::g, e);
+		this->write_transformable(e);
+		this->write_styleable(e);
+		this->write_children(record, e);
+		this->end_record(record);
+	}
+
+	void visit(const svg_element& e)override{
+		auto record = this->begin_record(element_type::svg, e);
+		this->write_rectangle(e);
+		this->write_view_boxed(e);
+		this->write_aspect_ratioed(e);
+		this->write_styleable(e);
+		this->write_children(record, e);
+		this->end_record(record);
+	}
+
+	void visit(const symbol_element& e)override{
+		auto record = this->begin_record(element_type::symbol, e);
+		this->write_view_boxed(e);
+		this->write_aspect_ratioed(e);
+		this->write_styleable(e);
+		this->write_children(record, e);
+		this->end_record(record);
+	}
+
+	void visit(const use_element& e)override{
+		auto record = this->begin_record(element_type::use, e);
+		this->write_transformable(e);
+		this->write_referencing(e);
+		this->write_rectangle(e);
+		this->write_styleable(e);
+		this->end_record(record);
+	}
+
+	void visit(const defs_element& e)override{
+		auto record = this->begin_record(element_type::defs, e);
+		this->write_transformable(e);
+		this->write_styleable(e);
+		this->write_children(record, e);
+		this->end_record(record);
+	}
+
+	void visit(const gradient::stop_element& e)override{
+		auto record = this->begin_record(element_type::stop, e);
+		this->write_styleable(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->out.write(e.offset);
+		this->end_record(record);
+	}
+
+	void visit(const linear_gradient_element& e)override{
+		auto record = this->begin_record(element_type::linear_gradient, e);
+		this->write_gradient(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->out.write_length(e.x1);
+		this->out.write_length(e.y1);
+		this->out.write_length(e.x2);
+		this->out.write_length(e.y2);
+		this->write_children(record, e);
+		this->end_record(record);
+	}
+
+	void visit(const radial_gradient_element& e)override{
+		auto record = this->begin_record(element_type::radial_gradient, e);
+		this->write_gradient(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->out.write_length(e.cx);
+		this->out.write_length(e.cy);
+		this->out.write_length(e.r);
+		this->out.write_length(e.fx);
+		this->out.write_length(e.fy);
+		this->write_children(record, e);
+		this->end_record(record);
+	}
+
+	void visit(const filter_element& e)override{
+		auto record = this->begin_record(element_type::filter, e);
+		this->write_styleable(e);
+		this->write_rectangle(e);
+		this->write_referencing(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->out.write_value(e.filter_units);
+		this->out.write_value(e.primitive_units);
+		this->write_children(record, e);
+		this->end_record(record);
+	}
+
+	void visit(const fe_gaussian_blur_element& e)override{
+		auto record = this->begin_record(element_type::fe_gaussian_blur, e);
+		this->write_filter_primitive(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->out.write_string(e.in);
+		this->out.write(e.std_deviation.x());
+		this->out.write(e.std_deviation.y());
+		this->end_record(record);
+	}
+
+	void visit(const fe_color_matrix_element& e)override{
+		auto record = this->begin_record(element_type::fe_color_matrix, e);
+		this->write_filter_primitive(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->out.write_string(e.in);
+		this->out.write_value(e.type_);
+		for(auto v : e.values){
+			this->out.write(v);
+		}
+		this->end_record(record);
+	}
+
+	void visit(const fe_blend_element& e)override{
+		auto record = this->begin_record(element_type::fe_blend, e);
+		this->write_filter_primitive(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->out.write_string(e.in);
+		this->out.write_string(e.in2);
+		this->out.write_value(e.mode_);
+		this->end_record(record);
+	}
+
+	void visit(const fe_composite_element& e)override{
+		auto record = this->begin_record(element_type::fe_composite, e);
+		this->write_filter_primitive(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->out.write_string(e.in);
+		this->out.write_string(e.in2);
+		this->out.write_value(e.operator__);
+		this->out.write(e.k1);
+		this->out.write(e.k2);
+		this->out.write(e.k3);
+		this->out.write(e.k4);
+		this->end_record(record);
+	}
+
+	void visit(const image_element& e)override{
+		auto record = this->begin_record(element_type::image, e);
+		this->write_styleable(e);
+		this->write_transformable(e);
+		this->write_rectangle(e);
+		this->write_referencing(e);
+		this->write_aspect_ratioed(e);
+		this->end_record(record);
+	}
+
+	void visit(const mask_element& e)override{
+		auto record = this->begin_record(element_type::mask, e);
+		this->write_rectangle(e);
+		this->write_styleable(e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->out.write_value(e.mask_units);
+		this->out.write_value(e.mask_content_units);
+		this->write_children(record, e);
+		this->end_record(record);
+	}
+
+	void visit(const text_element& e)override{
+		auto record = this->begin_record(element_type::text, e);
+		this->write_styleable(e);
+		this->write_transformable(e);
+		this->write_children(record, e);
+		this->end_record(record);
+	}
+
+	void visit(const style_element& e)override{
+		auto record = this->begin_record(element_type::style, e);
+		this->mark(offsetof(snapshot_record, specific));
+		this->write_css(e.css);
+		this->end_record(record);
+	}
+
+	void default_visit(const element& e)override{
+		// custom elements are not stored
+	}
+
+	void default_visit(const element& e, const container& c)override{
+		// custom elements are not stored
+	}
+};
+}
+
+std::vector<uint8_t> svgdom::save_snapshot(const svg_element& root, uint64_t source_key){
+	snapshot_writer w;
+
+	snapshot_header header{};
+	w.out.write(header); // placeholder, the header is written when the size is known
+
+	root.accept(w);
+
+	header.magic = snapshot_magic;
+	header.version = snapshot_version;
+	header.byte_order = snapshot_byte_order_mark;
+	header.real_size = uint16_t(sizeof(real));
+	header.num_style_properties = uint16_t(style_property::ENUM_SIZE);
+	header.size = uint32_t(w.out.pos());
+	header.source_key = source_key;
+	w.out.write_at(0, header);
+
+	return std::move(w.out.buf);
+}
+
+void svgdom::read_transformable(snapshot_input& in, transformable& e){
+	auto size = in.read<uint32_t>();
+	for(uint32_t i = 0; i != size; ++i){
+		transformable::transformation t{};
+		t.type_ = in.read_value<decltype(t.type_)>();
+		switch(t.type_){
+			case transformable::transformation::type::matrix:
+				t.a = in.read<real>();
+				t.b = in.read<real>();
+				t.c = in.read<real>();
+				t.d = in.read<real>();
+				t.e = in.read<real>();
+				t.f = in.read<real>();
+				break;
+			case transformable::transformation::type::translate:
+			case transformable::transformation::type::scale:
+				t.x = in.read<real>();
+				t.y = in.read<real>();
+				break;
+			case transformable::transformation::type::rotate:
+				t.angle = in.read<real>();
+				t.x = in.read<real>();
+				t.y = in.read<real>();
+				break;
+			case transformable::transformation::type::skewx:
+			case transformable::transformation::type::skewy:
+				t.angle = in.read<real>();
+				break;
+			default:
+				throw snapshot_error("snapshot contains invalid transformation type");
+		}
+		e.transformations.push_back(t);
+	}
+}
+
+namespace{
+void read_styleable(snapshot_input& in, styleable& e){
+	in.read_style_map(e.styles);
+	in.read_style_map(e.presentation_attributes);
+	e.classes = in.read_strings();
+}
+
+void read_rectangle(snapshot_input& in, rectangle& e){
+	e.x = in.read_length();
+	e.y = in.read_length();
+	e.width = in.read_length();
+	e.height = in.read_length();
+}
+
+void read_referencing(snapshot_input& in, referencing& e){
+	e.iri = in.read_string();
+}
+
+void read_view_boxed(snapshot_input& in, view_boxed& e){
+	for(auto& v : e.view_box){
+		v = in.read<real>();
+	}
+}
+
+void read_aspect_ratioed(snapshot_input& in, aspect_ratioed& e){
+	e.preserve_aspect_ratio.preserve = in.read_value<aspect_ratioed::aspect_ratio_preservation>();
+	e.preserve_aspect_ratio.defer = in.read<uint8_t>() != 0;
+	e.preserve_aspect_ratio.slice = in.read<uint8_t>() != 0;
+}
+
+void read_shape(snapshot_input& in, shape& e){
+	read_transformable(in, e);
+	read_styleable(in, e);
+}
+
+void read_points(snapshot_input& in, polyline_shape& e){
+	auto coordinates = in.read_reals();
+	if(coordinates.size() % 2 != 0){
+		throw snapshot_error("snapshot contains odd number of polyline coordinates");
+	}
+	e.points.reserve(coordinates.size() / 2);
+	for(size_t i = 0; i != coordinates.size(); i += 2){
+		e.points.push_back(r4::vector2<real>(coordinates[i], coordinates[i + 1]));
+	}
+}
+
+void read_gradient(snapshot_input& in, gradient& e){
+	read_referencing(in, e);
+	read_transformable(in, e);
+	read_styleable(in, e);
+	e.spread_method_ = in.read_value<gradient::spread_method>();
+	e.units = in.read_value<coordinate_units>();
+}
+
+void read_filter_primitive(snapshot_input& in, filter_primitive& e){
+	read_rectangle(in, e);
+	read_styleable(in, e);
+	e.result = in.read_string();
+}
+
+void read_css(snapshot_input& in, cssdom::document& css){
+	auto num_styles = in.read<uint32_t>();
+	for(uint32_t i = 0; i != num_styles; ++i){
+		cssdom::style s;
+		auto num_selectors = in.read<uint32_t>();
+		for(uint32_t j = 0; j != num_selectors; ++j){
+			cssdom::selector sel;
+			sel.tag = in.read_string();
+			sel.id = in.read_string();
+			sel.classes = in.read_strings();
+			sel.combinator = in.read_value<cssdom::combinator>();
+			s.selectors.push_back(std::move(sel));
+		}
+		auto num_properties = in.read<uint32_t>();
+		for(uint32_t j = 0; j != num_properties; ++j){
+			cssdom::property p;
+			p.id = in.read<uint32_t>();
+			p.is_important = in.read<uint8_t>() != 0;
+			if(in.read<uint8_t>() != 0){
+				auto v = std::make_unique<style_element::css_style_value>();
+				v->value = in.read_style_value();
+				p.value = std::move(v);
+			}
+			s.properties.push_back(std::move(p));
+		}
+		s.specificity = in.read<uint32_t>();
+		css.styles.push_back(std::move(s));
+	}
+}
+
+}
+
+void svgdom::read_attributes(snapshot_input& in, path_element& e){
+	read_shape(in, e);
+	auto num_commands = in.read<uint32_t>();
+	auto commands = in.read_bytes(num_commands);
+	auto coordinates = in.read_reals();
+	try{
+		e.path.assign(utki::make_span(commands, num_commands), coordinates);
+	}catch(std::invalid_argument&){
+		throw snapshot_error("snapshot contains invalid path data");
+	}
+}
+
+void svgdom::read_attributes(snapshot_input& in, rect_element& e){
+	read_shape(in, e);
+	read_rectangle(in, e);
+	e.rx = in.read_length();
+	e.ry = in.read_length();
+}
+
+void svgdom::read_attributes(snapshot_input& in, circle_element& e){
+	read_shape(in, e);
+	e.cx = in.read_length();
+	e.cy = in.read_length();
+	e.r = in.read_length();
+}
+
+void svgdom::read_attributes(snapshot_input& in, ellipse_element& e){
+	read_shape(in, e);
+	e.cx = in.read_length();
+	e.cy = in.read_length();
+	e.rx = in.read_length();
+	e.ry = in.read_length();
+}
+
+void svgdom::read_attributes(snapshot_input& in, line_element& e){
+	read_shape(in, e);
+	e.x1 = in.read_length();
+	e.y1 = in.read_length();
+	e.x2 = in.read_length();
+	e.y2 = in.read_length();
+}
+
+void svgdom::read_attributes(snapshot_input& in, polyline_element& e){
+	read_shape(in, e);
+	read_points(in, e);
+}
+
+void svgdom::read_attributes(snapshot_input& in, polygon_element& e){
+	read_shape(in, e);
+	read_points(in, e);
+}
+
+void svgdom::read_attributes(snapshot_input& in, g_element& e){
+	read_transformable(in, e);
+	read_styleable(in, e);
+}
+
+void svgdom::read_attributes(snapshot_input& in, svg_element& e){
+	read_rectangle(in, e);
+	read_view_boxed(in, e);
+	read_aspect_ratioed(in, e);
+	read_styleable(in, e);
+}
+
+void svgdom::read_attributes(snapshot_input& in, symbol_element& e){
+	read_view_boxed(in, e);
+	read_aspect_ratioed(in, e);
+	read_styleable(in, e);
+}
+
+void svgdom::read_attributes(snapshot_input& in, use_element& e){
+	read_transformable(in, e);
+	read_referencing(in, e);
+	read_rectangle(in, e);
+	read_styleable(in, e);
+}
+
+void svgdom::read_attributes(snapshot_input& in, defs_element& e){
+	read_transformable(in, e);
+	read_styleable(in, e);
+}
+
+void svgdom::read_attributes(snapshot_input& in, gradient::stop_element& e){
+	read_styleable(in, e);
+	e.offset = in.read<real>();
+}
+
+void svgdom::read_attributes(snapshot_input& in, linear_gradient_element& e){
+	read_gradient(in, e);
+	e.x1 = in.read_length();
+	e.y1 = in.read_length();
+	e.x2 = in.read_length();
+	e.y2 = in.read_length();
+}
+
+void svgdom::read_attributes(snapshot_input& in, radial_gradient_element& e){
+	read_gradient(in, e);
+	e.cx = in.read_length();
+	e.cy = in.read_length();
+	e.r = in.read_length();
+	e.fx = in.read_length();
+	e.fy = in.read_length();
+}
+
+void svgdom::read_attributes(snapshot_input& in, filter_element& e){
+	read_styleable(in, e);
+	read_rectangle(in, e);
+	read_referencing(in, e);
+	e.filter_units = in.read_value<coordinate_units>();
+	e.primitive_units = in.read_value<coordinate_units>();
+}
+
+void svgdom::read_attributes(snapshot_input& in, fe_gaussian_blur_element& e){
+	read_filter_primitive(in, e);
+	e.in = in.read_string();
+	e.std_deviation.x() = in.read<real>();
+	e.std_deviation.y() = in.read<real>();
+}
+
+void svgdom::read_attributes(snapshot_input& in, fe_color_matrix_element& e){
+	read_filter_primitive(in, e);
+	e.in = in.read_string();
+	e.type_ = in.read_value<fe_color_matrix_element::type>();
+	for(auto& v : e.values){
+		v = in.read<real>();
+	}
+}
+
+void svgdom::read_attributes(snapshot_input& in, fe_blend_element& e){
+	read_filter_primitive(in, e);
+	e.in = in.read_string();
+	e.in2 = in.read_string();
+	e.mode_ = in.read_value<fe_blend_element::mode>();
+}
+
+void svgdom::read_attributes(snapshot_input& in, fe_composite_element& e){
+	read_filter_primitive(in, e);
+	e.in = in.read_string();
+	e.in2 = in.read_string();
+	e.operator__ = in.read_value<fe_composite_element::operator_>();
+	e.k1 = in.read<real>();
+	e.k2 = in.read<real>();
+	e.k3 = in.read<real>();
+	e.k4 = in.read<real>();
+}
+
+void svgdom::read_attributes(snapshot_input& in, image_element& e){
+	read_styleable(in, e);
+	read_transformable(in, e);
+	read_rectangle(in, e);
+	read_referencing(in, e);
+	read_aspect_ratioed(in, e);
+}
+
+void svgdom::read_attributes(snapshot_input& in, mask_element& e){
+	read_rectangle(in, e);
+	read_styleable(in, e);
+	e.mask_units = in.read_value<coordinate_units>();
+	e.mask_content_units = in.read_value<coordinate_units>();
+}
+
+void svgdom::read_attributes(snapshot_input& in, text_element& e){
+	read_styleable(in, e);
+	read_transformable(in, e);
+}
+
+void svgdom::read_attributes(snapshot_input& in, style_element& e){
+	read_css(in, e.css);
+	e.selector_index = css_selector_index(e.css);
+}
+
+snapshot_record snapshot_input::read_record(size_t record, size_t parent_end){
+	this->seek(record);
+	auto r = this->read<snapshot_record>();
+
+	auto is_valid_offset = [&r](uint32_t offset){
+		return offset == 0 || (offset >= sizeof(snapshot_record) && offset <= r.children);
+	};
+
+	if(
+			r.size < sizeof(snapshot_record) ||
+			r.size > parent_end - record ||
+			r.size % snapshot_record_alignment != 0 ||
+			r.children < sizeof(snapshot_record) ||
+			r.children > r.size ||
+			!is_valid_offset(r.transformable) ||
+			!is_valid_offset(r.styleable) ||
+			!is_valid_offset(r.rectangle) ||
+			!is_valid_offset(r.referencing) ||
+			!is_valid_offset(r.view_boxed) ||
+			!is_valid_offset(r.specific)
+		)
+	{
+		throw snapshot_error("snapshot contains invalid element record");
+	}
+	return r;
+}
+
+size_t svgdom::read_snapshot_header(snapshot_input& in, uint64_t source_key){
+	in.seek(0);
+	auto header = in.read<snapshot_header>();
+	if(header.magic != snapshot_magic){
+		throw snapshot_error("data is not an svgdom snapshot");
+	}
+	if(header.version != snapshot_version){
+		throw snapshot_error("snapshot version is not supported");
+	}
+	if(
+			header.byte_order != snapshot_byte_order_mark ||
+			header.real_size != sizeof(real) ||
+			header.num_style_properties != uint16_t(style_property::ENUM_SIZE)
+		)
+	{
+		throw snapshot_error("snapshot was made by incompatible build of svgdom");
+	}
+	if(header.size != in.size()){
+		throw snapshot_error("snapshot is truncated");
+	}
+	if(header.source_key != source_key){
+		throw snapshot_error("snapshot is stale, source key does not match");
+	}
+	return in.pos();
+}
+
+namespace{
+std::unique_ptr<element> read_element(snapshot_input& in, size_t record, size_t parent_end);
+
+// reads element of the dispatched type, see dispatch_element_type()
+struct element_reader{
+	snapshot_input& in;
+	const snapshot_record& r;
+	size_t record;
+	std::unique_ptr<element> e;
+
+	template <class T> void on(){
+		auto e = std::make_unique<T>();
+		e->id = this->in.read_string();
+		read_attributes(this->in, *e);
+
+		auto children_begin = this->record + this->r.children;
+		auto end = this->record + this->r.size;
+		if(this->in.pos() > children_begin){
+			throw snapshot_error("snapshot contains invalid element record");
+		}
+
+		if constexpr (std::is_base_of<container, T>::value){
+			for(auto child = children_begin; child != end;){
+				auto c = read_element(this->in, child, end);
+				child = this->in.pos();
+				e->children.push_back(std::move(c));
+			}
+		}
+
+		this->e = std::move(e);
+	}
+};
+
+std::unique_ptr<element> read_element(snapshot_input& in, size_t record, size_t parent_end){
+	auto r = in.read_record(record, parent_end);
+
+	element_reader reader{in, r, record, nullptr};
+	dispatch_element_type(r.type, reader);
+
+	in.seek(record + r.size);
+	return std::move(reader.e);
+}
+}
+
+std::unique_ptr<svg_element> svgdom::load_snapshot(utki::span<const uint8_t> data, uint64_t source_key){
+	if(reinterpret_cast<uintptr_t>(data.data()) % alignof(real) != 0){
+		// real numbers are read in place, so copy the data to properly aligned memory
+		std::vector<uint8_t> aligned(data.begin(), data.end());
+		return load_snapshot(utki::make_span(aligned), source_key);
+	}
+
+	snapshot_input in(data);
+
+	auto root_record = read_snapshot_header(in, source_key);
+
+	auto root = read_element(in, root_record, data.size());
+	if(in.pos() != data.size()){
+		throw snapshot_error("snapshot contains extra data after root element");
+	}
+
+	auto ret = std::unique_ptr<svg_element>(dynamic_cast<svg_element*>(root.get()));
+	if(!ret){
+		throw snapshot_error("snapshot root element is not 'svg'");
+	}
+	root.release();
+	return ret;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <cstdint>
+
+#include <utki/span.hpp>
+
+#include "elements/structurals.hpp"
+
+namespace svgdom{
+
+/**
+ * @brief Error of reading binary snapshot.
+ * Thrown when snapshot data is truncated or corrupted, was written by incompatible
+ * version of the library or on a machine with different byte order, or was made
+ * from a different source document, see make_snapshot_source_key().
+ */
+class snapshot_error : public std::runtime_error{
+public:
+	snapshot_error(const std::string& message) :
+			std::runtime_error(message)
+	{}
+};
+
+/**
+ * @brief Calculate source key for snapshot.
+ * The key is a 64 bit hash of the SVG document text. Storing it in the snapshot allows
+ * rejecting the snapshot when the SVG document it was made from has changed.
+ * Hashing the text is much faster than parsing it.
+ * @param svg - SVG document text.
+ * @return source key.
+ */
+uint64_t make_snapshot_source_key(utki::span<const char> svg)noexcept;
+
+/**
+ * @brief Save SVG document tree to binary snapshot.
+ * The snapshot contains all the elements of the tree with all their attributes,
+ * including parsed path data, transformations, styles and CSS of 'style' elements.
+ * Loading the snapshot is a linear decoding of the data, no text parsing is involved.
+ * Lazily loaded attributes are parsed when saving. Elements of custom types,
+ * i.e. not known to the visitor, are skipped.
+ * The snapshot format is native to the machine, i.e. it uses native byte order and
+ * size of real numbers, snapshots made on incompatible machine are rejected when loading.
+ * @param root - root of the SVG document tree to save.
+ * @param source_key - arbitrary key to store in the snapshot, see make_snapshot_source_key().
+ * @return snapshot data.
+ */
+std::vector<uint8_t> save_snapshot(const svg_element& root, uint64_t source_key = 0);
+
+/**
+ * @brief Load SVG document tree from binary snapshot.
+ * @param data - snapshot data, as returned by save_snapshot().
+ * @param source_key - expected source key of the snapshot.
+ * @return unique pointer to the root of SVG document tree.
+ * @throw snapshot_error - in case the snapshot data is invalid, is of incompatible version,
+ *                         or has different source key, i.e. the snapshot is stale.
+ */
+std::unique_ptr<svg_element> load_snapshot(utki::span<const uint8_t> data, uint64_t source_key = 0);
+
+}
@@ -0,0 +1,517 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <type_traits>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+#include <utki/span.hpp>
+#include <utki/debug.hpp>
+
+#include "config.hpp"
+#include "length.hpp"
+#include "snapshot.hpp"
+#include "elements/element_type.hpp"
+#include "elements/styleable.hpp"
+#include "visitor.hpp"
+
+// Binary snapshot layout.
+//
+// All values are stored in native byte order, with no padding, unless stated otherwise.
+// Enumeration values are stored as u8.
+//
+// snapshot:
+//     snapshot_header
+//     element record of the root 'svg' element
+//
+// element record, starts at offset aligned to snapshot_record_alignment:
+//     snapshot_record
+//     string id
+//     attribute groups, in order of element's base classes, see snapshot.cpp
+//     attributes specific to the element type
+//     child records
+//
+// string:
+//     u32 length
+//     characters
+//
+// length:
+//     real value
+//     u8 unit
+//
+// style value:
+//     u8 index of the style_value variant alternative
+//     value of the alternative
+//
+// Arrays of real numbers (path coordinates, polyline points) are aligned to alignof(real) from
+// the start of the snapshot, so that they can be accessed in place when the snapshot itself is
+// properly aligned, e.g. is memory mapped.
+
+namespace svgdom{
+
+/**
+ * @brief Version of the snapshot format.
+ * To be incremented on any change of the format or of the stored enumerations.
+ */
+constexpr uint32_t snapshot_version = 2;
+
+constexpr std::array<char, 8> snapshot_magic = {{'s', 'v', 'g', 'd', 'o', 'm', 's', 'n'}};
+
+constexpr uint32_t snapshot_byte_order_mark = 0x01020304;
+
+constexpr size_t snapshot_record_alignment = 4;
+
+struct snapshot_header{
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t byte_order;
+	uint16_t real_size;
+	uint16_t num_style_properties;
+	uint32_t size; // size of the whole snapshot, including the header
+	uint64_t source_key;
+};
+
+static_assert(sizeof(snapshot_header) == 32, "unexpected snapshot_header size");
+
+/**
+ * @brief Element record header.
+ * Offsets are from the start of the record. Offsets of attribute groups are 0 if the element
+ * does not have the group. Attribute groups can be accessed directly by the offsets, without
+ * decoding the preceding attributes.
+ */
+struct snapshot_record{
+	uint32_t size; // size of the record, including child records
+	uint32_t children; // offset of the first child record, equals to size if there are no children
+	uint32_t transformable;
+	uint32_t styleable;
+	uint32_t rectangle;
+	uint32_t referencing;
+	uint32_t view_boxed;
+	uint32_t specific; // attributes specific to the element type
+	element_type type;
+	std::array<uint8_t, 3> reserved;
+};
+
+static_assert(sizeof(snapshot_record) == 36, "unexpected snapshot_record size");
+static_assert(sizeof(snapshot_record) % snapshot_record_alignment == 0, "snapshot_record size is not aligned");
+
+/**
+ * @brief Write snapshot data to memory buffer.
+ */
+class snapshot_output{
+public:
+	std::vector<uint8_t> buf;
+
+	size_t pos()const noexcept{
+		return this->buf.size();
+	}
+
+	template <typename T> void write(const T& v){
+		static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be written as is");
+		this->write_bytes(&v, sizeof(v));
+	}
+
+	template <typename T> void write_at(size_t pos, const T& v){
+		static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be written as is");
+		std::memcpy(this->buf.data() + pos, &v, sizeof(v));
+	}
+
+	void write_bytes(const void* data, size_t size){
+		auto p = this->buf.size();
+		this->buf.resize(p + size);
+		if(size != 0){
+			std::memcpy(this->buf.data() + p, data, size);
+		}
+	}
+
+	void align(size_t alignment){
+		this->buf.resize((this->buf.size() + alignment - 1) / alignment * alignment, 0);
+	}
+
+	void write_string(std::string_view str){
+		this->write(uint32_t(str.size()));
+		this->write_bytes(str.data(), str.size());
+	}
+
+	void write_strings(const std::vector<std::string>& strs);
+
+	void write_length(const length& l){
+		this->write(l.value);
+		this->write(uint8_t(l.unit));
+	}
+
+	void write_reals(utki::span<const real> values){
+		this->write(uint32_t(values.size()));
+		this->align(alignof(real));
+		this->write_bytes(values.data(), values.size() * sizeof(real));
+	}
+
+	template <typename T> void write_value(const T& v){
+		if constexpr (std::is_enum<T>::value){
+			this->write(uint8_t(v));
+		}else if constexpr (std::is_same<T, length>::value){
+			this->write_length(v);
+		}else if constexpr (std::is_same<T, std::string>::value){
+			this->write_string(v);
+		}else if constexpr (std::is_same<T, std::vector<length>>::value){
+			this->write(uint32_t(v.size()));
+			for(auto& l : v){
+				this->write_length(l);
+			}
+		}else if constexpr (std::is_same<T, enable_background_property>::value){
+			this->write(uint8_t(v.value));
+			this->write(v.rect.p.x());
+			this->write(v.rect.p.y());
+			this->write(v.rect.d.x());
+			this->write(v.rect.d.y());
+		}else{
+			static_assert(std::is_arithmetic<T>::value, "unsupported value type");
+			this->write(v);
+		}
+	}
+
+	void write_style_value(const style_value& v){
+		this->write(uint8_t(v.index()));
+		std::visit(
+				[this](const auto& value){
+					this->write_value(value);
+				},
+				v
+			);
+	}
+
+	void write_style_map(const style_map& m);
+};
+
+// Last values of the enumerations stored in snapshots, values read from snapshot are checked against them.
+template <typename T> struct last_enum_value;
+#define SVGDOM_LAST_ENUM_VALUE(T, last) template <> struct last_enum_value<T>{ constexpr static T value = last; };
+SVGDOM_LAST_ENUM_VALUE(length_unit, length_unit::mm)
+SVGDOM_LAST_ENUM_VALUE(style_value_special, style_value_special::inherit)
+SVGDOM_LAST_ENUM_VALUE(stroke_line_cap, stroke_line_cap::square)
+SVGDOM_LAST_ENUM_VALUE(stroke_line_join, stroke_line_join::bevel)
+SVGDOM_LAST_ENUM_VALUE(fill_rule, fill_rule::evenodd)
+SVGDOM_LAST_ENUM_VALUE(color_interpolation, color_interpolation::linear_rgb)
+SVGDOM_LAST_ENUM_VALUE(display, display::none)
+SVGDOM_LAST_ENUM_VALUE(visibility, visibility::collapse)
+SVGDOM_LAST_ENUM_VALUE(enable_background, enable_background::new_)
+SVGDOM_LAST_ENUM_VALUE(transformable::transformation::type, transformable::transformation::type::skewy)
+SVGDOM_LAST_ENUM_VALUE(aspect_ratioed::aspect_ratio_preservation, aspect_ratioed::aspect_ratio_preservation::x_max_y_max)
+SVGDOM_LAST_ENUM_VALUE(gradient::spread_method, gradient::spread_method::repeat)
+SVGDOM_LAST_ENUM_VALUE(coordinate_units, coordinate_units::object_bounding_box)
+SVGDOM_LAST_ENUM_VALUE(cssdom::combinator, cssdom::combinator::subsequent_sibling)
+SVGDOM_LAST_ENUM_VALUE(fe_color_matrix_element::type, fe_color_matrix_element::type::luminance_to_alpha)
+SVGDOM_LAST_ENUM_VALUE(fe_blend_element::mode, fe_blend_element::mode::lighten)
+SVGDOM_LAST_ENUM_VALUE(fe_composite_element::operator_, fe_composite_element::operator_::arithmetic)
+#undef SVGDOM_LAST_ENUM_VALUE
+
+/**
+ * @brief Read snapshot data from memory buffer.
+ * All reads are bounds checked, reading past the end of data throws snapshot_error.
+ * Enumeration values are range checked, invalid value throws snapshot_error.
+ * The data must be aligned to alignof(real).
+ */
+class snapshot_input{
+	const uint8_t* begin;
+	const uint8_t* end;
+	const uint8_t* p;
+
+	void check(size_t size)const{
+		if(size_t(this->end - this->p) < size){
+			throw snapshot_error("snapshot is truncated");
+		}
+	}
+
+public:
+	snapshot_input(utki::span<const uint8_t> data) :
+			begin(data.data()),
+			end(data.data() + data.size()),
+			p(data.data())
+	{}
+
+	size_t pos()const noexcept{
+		return size_t(this->p - this->begin);
+	}
+
+	size_t size()const noexcept{
+		return size_t(this->end - this->begin);
+	}
+
+	void seek(size_t pos){
+		if(pos > size_t(this->end - this->begin)){
+			throw snapshot_error("snapshot is truncated");
+		}
+		this->p = this->begin + pos;
+	}
+
+	template <typename T> T read(){
+		static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be read as is");
+		this->check(sizeof(T));
+		T ret;
+		std::memcpy(&ret, this->p, sizeof(T));
+		this->p += sizeof(T);
+		return ret;
+	}
+
+	const uint8_t* read_bytes(size_t size){
+		this->check(size);
+		auto ret = this->p;
+		this->p += size;
+		return ret;
+	}
+
+	void align(size_t alignment){
+		this->seek((this->pos() + alignment - 1) / alignment * alignment);
+	}
+
+	std::string_view read_string(){
+		auto size = this->read<uint32_t>();
+		return std::string_view(reinterpret_cast<const char*>(this->read_bytes(size)), size);
+	}
+
+	std::vector<std::string> read_strings();
+
+	length read_length(){
+		auto value = this->read<real>();
+		auto unit = this->read_value<length_unit>();
+		return length(value, unit);
+	}
+
+	/**
+	 * @brief Read array of real numbers.
+	 * @return span of the numbers, pointing to the snapshot data.
+	 */
+	utki::span<const real> read_reals(){
+		auto size = this->read<uint32_t>();
+		this->align(alignof(real));
+		if(size > (size_t(this->end - this->p)) / sizeof(real)){
+			throw snapshot_error("snapshot is truncated");
+		}
+		auto p = this->read_bytes(size * sizeof(real));
+		ASSERT(reinterpret_cast<uintptr_t>(p) % alignof(real) == 0)
+		return utki::make_span(reinterpret_cast<const real*>(p), size);
+	}
+
+	template <typename T> T read_value(){
+		if constexpr (std::is_enum<T>::value){
+			auto v = this->read<uint8_t>();
+			if(v > uint8_t(last_enum_value<T>::value)){
+				throw snapshot_error("snapshot contains invalid enumeration value");
+			}
+			return T(v);
+		}else if constexpr (std::is_same<T, length>::value){
+			return this->read_length();
+		}else if constexpr (std::is_same<T, std::string>::value){
+			return std::string(this->read_string());
+		}else if constexpr (std::is_same<T, std::vector<length>>::value){
+			auto size = this->read<uint32_t>();
+			T ret;
+			ret.reserve(std::min(size_t(size), size_t(this->end - this->p)));
+			for(uint32_t i = 0; i != size; ++i){
+				ret.push_back(this->read_length());
+			}
+			return ret;
+		}else if constexpr (std::is_same<T, enable_background_property>::value){
+			T ret;
+			ret.value = this->read_value<enable_background>();
+			ret.rect.p.x() = this->read<real>();
+			ret.rect.p.y() = this->read<real>();
+			ret.rect.d.x() = this->read<real>();
+			ret.rect.d.y() = this->read<real>();
+			return ret;
+		}else{
+			static_assert(std::is_arithmetic<T>::value, "unsupported value type");
+			return this->read<T>();
+		}
+	}
+
+	template <size_t I = 0> style_value read_style_value(size_t index){
+		if constexpr (I == std::variant_size<style_value>::value){
+			throw snapshot_error("snapshot contains invalid style value type");
+		}else{
+			if(index != I){
+				return this->read_style_value<I + 1>(index);
+			}
+			return style_value(std::in_place_index<I>, this->read_value<std::variant_alternative_t<I, style_value>>());
+		}
+	}
+
+	style_property read_style_property(){
+		auto p = this->read<uint8_t>();
+		if(p == uint8_t(style_property::unknown) || p >= uint8_t(style_property::ENUM_SIZE)){
+			throw snapshot_error("snapshot contains invalid style property");
+		}
+		return style_property(p);
+	}
+
+	style_value read_style_value(){
+		return this->read_style_value(this->read<uint8_t>());
+	}
+
+	template <typename T> void skip_value(){
+		if constexpr (std::is_same<T, std::string>::value){
+			this->read_string();
+		}else if constexpr (std::is_same<T, std::vector<length>>::value){
+			constexpr size_t length_size = sizeof(real) + sizeof(uint8_t);
+			auto size = this->read<uint32_t>();
+			if(size > (size_t(this->end - this->p)) / length_size){
+				throw snapshot_error("snapshot is truncated");
+			}
+			this->read_bytes(size * length_size);
+		}else{
+			// fixed size value, reading it does not allocate memory
+			this->read_value<T>();
+		}
+	}
+
+	template <size_t I = 0> void skip_style_value(size_t index){
+		if constexpr (I == std::variant_size<style_value>::value){
+			throw snapshot_error("snapshot contains invalid style value type");
+		}else{
+			if(index != I){
+				this->skip_style_value<I + 1>(index);
+				return;
+			}
+			this->skip_value<std::variant_alternative_t<I, style_value>>();
+		}
+	}
+
+	void skip_style_value(){
+		this->skip_style_value(this->read<uint8_t>());
+	}
+
+	void read_style_map(style_map& m);
+
+	snapshot_record read_record(size_t record, size_t parent_end);
+};
+
+/**
+ * @brief Read and check snapshot header.
+ * @param in - input positioned at the start of the snapshot.
+ * @param source_key - expected source key.
+ * @return position of the root element record.
+ * @throw snapshot_error - in case the header is invalid or does not match.
+ */
+size_t read_snapshot_header(snapshot_input& in, uint64_t source_key);
+
+// Read transformations attribute group.
+void read_transformable(snapshot_input& in, transformable& e);
+
+// Read attributes of the element, except id and children.
+// The input must be positioned right after the element id.
+void read_attributes(snapshot_input& in, path_element& e);
+void read_attributes(snapshot_input& in, rect_element& e);
+void read_attributes(snapshot_input& in, circle_element& e);
+void read_attributes(snapshot_input& in, ellipse_element& e);
+void read_attributes(snapshot_input& in, line_element& e);
+void read_attributes(snapshot_input& in, polyline_element& e);
+void read_attributes(snapshot_input& in, polygon_element& e);
+void read_attributes(snapshot_input& in, g_element& e);
+void read_attributes(snapshot_input& in, svg_element& e);
+void read_attributes(snapshot_input& in, symbol_element& e);
+void read_attributes(snapshot_input& in, use_element& e);
+void read_attributes(snapshot_input& in, defs_element& e);
+void read_attributes(snapshot_input& in, gradient::stop_element& e);
+void read_attributes(snapshot_input& in, linear_gradient_element& e);
+void read_attributes(snapshot_input& in, radial_gradient_element& e);
+void read_attributes(snapshot_input& in, filter_element& e);
+void read_attributes(snapshot_input& in, fe_gaussian_blur_element& e);
+void read_attributes(snapshot_input& in, fe_color_matrix_element& e);
+void read_attributes(snapshot_input& in, fe_blend_element& e);
+void read_attributes(snapshot_input& in, fe_composite_element& e);
+void read_attributes(snapshot_input& in, image_element& e);
+void read_attributes(snapshot_input& in, mask_element& e);
+void read_attributes(snapshot_input& in, text_element& e);
+void read_attributes(snapshot_input& in, style_element& e);
+
+/**
+ * @brief Call handler's template method for element class corresponding to element type.
+ * @param type - element type.
+ * @param handler - object with 'template <class T> void on()' method.
+ * @throw snapshot_error - in case the element type is unknown.
+ */
+template <typename T_handler> void dispatch_element_type(element_type type, T_handler& handler){
+	switch(type){
+		case element_type::path:
+			handler.template on<path_element>();
+			break;
+		case element_type::rect:
+			handler.template on<rect_element>();
+			break;
+		case element_type::circle:
+			handler.template on<circle_element>();
+			break;
+		case element_type::ellipse:
+			handler.template on<ellipse_element>();
+			break;
+		case element_type::line:
+			handler.template on<line_element>();
+			break;
+		case element_type::polyline:
+			handler.template on<polyline_element>();
+			break;
+		case element_type::polygon:
+			handler.template on<polygon_element>();
+			break;
+		case element_type::g:
+			handler.template on<g_element>();
+			break;
+		case element_type::svg:
+			handler.template on<svg_element>();
+			break;
+		case element_type::symbol:
+			handler.template on<symbol_element>();
+			break;
+		case element_type::use:
+			handler.template on<use_element>();
+			break;
+		case element_type::defs:
+			handler.template on<defs_element>();
+			break;
+		case element_type::stop:
+			handler.template on<gradient::stop_element>();
+			break;
+		case element_type::linear_gradient:
+			handler.template on<linear_gradient_element>();
+			break;
+		case element_type::radial_gradient:
+			handler.template on<radial_gradient_element>();
+			break;
+		case element_type::filter:
+			handler.template on<filter_element>();
+			break;
+		case element_type::fe_gaussian_blur:
+			handler.template on<fe_gaussian_blur_element>();
+			break;
+		case element_type::fe_color_matrix:
+			handler.template on<fe_color_matrix_element>();
+			break;
+		case element_type::fe_blend:
+			handler.template on<fe_blend_element>();
+			break;
+		case element_type::fe_composite:
+			handler.template on<fe_composite_element>();
+			break;
+		case element_type::image:
+			handler.template on<image_element>();
+			break;
+		case element_type::mask:
+			handler.template on<mask_element>();
+			break;
+		case element_type::text:
+			handler.template on<text_element>();
+			break;
+		case element_type::style:
+			handler.template on<style_element>();
+			break;
+		default:
+			throw snapshot_error("snapshot contains unknown element type");
+	}
+}
+
+}
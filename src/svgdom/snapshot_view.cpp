@@ -0,0 +1,354 @@
+#include "snapshot_view.hpp"
+
+#include <cstddef>
+
+#include <utki/util.hpp>
+
+#include "snapshot_format.hxx"
+#include "mapped_file.hxx"
+#include "visitor.hpp"
+
+using namespace svgdom;
+
+element_view::const_iterator::const_iterator(const uint8_t* data, size_t data_size, size_t record, size_t end) :
+		data(data),
+		data_size(data_size),
+		record(record),
+		end(end)
+{}
+
+element_view::const_iterator& element_view::const_iterator::operator++(){
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	auto r = in.read_record(this->record, this->end);
+	this->record += r.size;
+	return *this;
+}
+
+element_type element_view::type()const{
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	return in.read_record(this->record, this->data_size).type;
+}
+
+std::string_view element_view::id()const{
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	in.read_record(this->record, this->data_size);
+	return in.read_string();
+}
+
+element_view::children_range element_view::children()const{
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	auto r = in.read_record(this->record, this->data_size);
+	auto end = this->record + r.size;
+	return children_range(
+			const_iterator(this->data, this->data_size, this->record + r.children, end),
+			const_iterator(this->data, this->data_size, end, end)
+		);
+}
+
+size_t element_view::group_offset(size_t field_offset)const{
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	auto r = in.read_record(this->record, this->data_size);
+	uint32_t offset;
+	std::memcpy(&offset, reinterpret_cast<const uint8_t*>(&r) + field_offset, sizeof(offset));
+	if(offset == 0){
+		return 0;
+	}
+	return this->record + offset;
+}
+
+style_value element_view::find_style_value(size_t style_map_index, style_property p)const{
+	auto offset = this->group_offset(offsetof(snapshot_record, styleable));
+	if(offset == 0){
+		return style_value();
+	}
+
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	in.seek(offset);
+
+	for(size_t i = 0;; ++i){
+		auto size = in.read<uint32_t>();
+		for(uint32_t j = 0; j != size; ++j){
+			auto property = in.read_style_property();
+			if(i == style_map_index && property == p){
+				return in.read_style_value();
+			}
+			in.skip_style_value();
+		}
+		if(i == style_map_index){
+			return style_value();
+		}
+	}
+}
+
+style_value element_view::get_style_property(style_property p)const{
+	return this->find_style_value(0, p);
+}
+
+style_value element_view::get_presentation_attribute(style_property p)const{
+	return this->find_style_value(1, p);
+}
+
+std::vector<transformable::transformation> element_view::get_transformations()const{
+	auto offset = this->group_offset(offsetof(snapshot_record, transformable));
+	if(offset == 0){
+		return std::vector<transformable::transformation>();
+	}
+
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	in.seek(offset);
+
+	transformable t;
+	read_transformable(in, t);
+	return std::vector<transformable::transformation>(t.transformations.begin(), t.transformations.end());
+}
+
+rectangle element_view::get_rectangle()const{
+	rectangle ret;
+
+	auto offset = this->group_offset(offsetof(snapshot_record, rectangle));
+	if(offset == 0){
+		return ret;
+	}
+
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	in.seek(offset);
+
+	ret.x = in.read_length();
+	ret.y = in.read_length();
+	ret.width = in.read_length();
+	ret.height = in.read_length();
+	return ret;
+}
+
+decltype(view_boxed::view_box) element_view::get_view_box()const{
+	view_boxed ret;
+
+	auto offset = this->group_offset(offsetof(snapshot_record, view_boxed));
+	if(offset == 0){
+		return ret.view_box;
+	}
+
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	in.seek(offset);
+
+	for(auto& v : ret.view_box){
+		v = in.read<real>();
+	}
+	return ret.view_box;
+}
+
+std::string_view element_view::get_iri()const{
+	auto offset = this->group_offset(offsetof(snapshot_record, referencing));
+	if(offset == 0){
+		return std::string_view();
+	}
+
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	in.seek(offset);
+	return in.read_string();
+}
+
+namespace{
+// index of the length among the attributes specific to element type, or -1 if element does not have the attribute
+int length_index(element_type type, element_view::length_attribute a){
+	typedef element_view::length_attribute la;
+	switch(type){
+		case element_type::rect:
+			switch(a){
+				case la::rx: return 0;
+				case la::ry: return 1;
+				default: return -1;
+			}
+		case element_type::circle:
+			switch(a){
+				case la::cx: return 0;
+				case la::cy: return 1;
+				case la::r: return 2;
+				default: return -1;
+			}
+		case element_type::ellipse:
+			switch(a){
+				case la::cx: return 0;
+				case la::cy: return 1;
+				case la::rx: return 2;
+				case la::ry: return 3;
+				default: return -1;
+			}
+		case element_type::line:
+		case element_type::linear_gradient:
+			switch(a){
+				case la::x1: return 0;
+				case la::y1: return 1;
+				case la::x2: return 2;
+				case la::y2: return 3;
+				default: return -1;
+			}
+		case element_type::radial_gradient:
+			switch(a){
+				case la::cx: return 0;
+				case la::cy: return 1;
+				case la::r: return 2;
+				case la::fx: return 3;
+				case la::fy: return 4;
+				default: return -1;
+			}
+		default:
+			return -1;
+	}
+}
+}
+
+length element_view::get_length(length_attribute a)const{
+	auto index = length_index(this->type(), a);
+	auto offset = this->group_offset(offsetof(snapshot_record, specific));
+	if(index < 0 || offset == 0){
+		return length(0, length_unit::unknown);
+	}
+
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	in.seek(offset + size_t(index) * (sizeof(real) + sizeof(uint8_t)));
+	return in.read_length();
+}
+
+utki::span<const uint8_t> element_view::get_path_commands()const{
+	if(this->type() != element_type::path){
+		return utki::span<const uint8_t>();
+	}
+
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	in.seek(this->group_offset(offsetof(snapshot_record, specific)));
+	auto size = in.read<uint32_t>();
+	auto ret = utki::make_span(in.read_bytes(size), size);
+	for(auto c : ret){
+		if(!path_element::packed_path::is_valid_command(c)){
+			throw snapshot_error("snapshot contains invalid path data");
+		}
+	}
+	return ret;
+}
+
+utki::span<const real> element_view::get_path_coordinates()const{
+	if(this->type() != element_type::path){
+		return utki::span<const real>();
+	}
+
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	in.seek(this->group_offset(offsetof(snapshot_record, specific)));
+	in.read_bytes(in.read<uint32_t>()); // skip commands
+	return in.read_reals();
+}
+
+utki::span<const real> element_view::get_points()const{
+	auto type = this->type();
+	if(type != element_type::polyline && type != element_type::polygon){
+		return utki::span<const real>();
+	}
+
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	in.seek(this->group_offset(offsetof(snapshot_record, specific)));
+	return in.read_reals();
+}
+
+// element decoded from the view, children of container element are decoded when it accepts a visitor
+template <class T> class element_view::decoded_element final : public T{
+	element_view view;
+
+	// decodes children for the time of visiting, so that only the elements on the path
+	// from the root to the currently visited element, and their siblings, are decoded at a time
+	template <class T_visitor> void accept_with_children(T_visitor& v){
+		if constexpr (std::is_base_of<container, T>::value){
+			auto& children = this->children;
+			if(!children.empty()){
+				// the element accepts another visitor while being visited, children are already decoded
+				this->T::accept(v);
+				return;
+			}
+			utki::scope_exit clear_children([&children](){
+				children.clear();
+			});
+			for(auto c : this->view.children()){
+				children.push_back(c.decode());
+			}
+			this->T::accept(v);
+		}else{
+			this->T::accept(v);
+		}
+	}
+public:
+	decoded_element(const element_view& view) :
+			view(view)
+	{}
+
+	void accept(visitor& v)override{
+		this->accept_with_children(v);
+	}
+
+	void accept(const_visitor& v)const override{
+		// the object itself is never constant, only the accept() method is
+		const_cast<decoded_element&>(*this).accept_with_children(v);
+	}
+};
+
+// decodes element of the dispatched type to temporary object
+struct element_view::decoder{
+	snapshot_input& in;
+	const element_view& view;
+	std::unique_ptr<element> e;
+
+	template <class T> void on(){
+		auto e = std::make_unique<decoded_element<T>>(this->view);
+		e->id = this->in.read_string();
+		read_attributes(this->in, *e);
+		this->e = std::move(e);
+	}
+};
+
+std::unique_ptr<element> element_view::decode()const{
+	snapshot_input in(utki::make_span(this->data, this->data_size));
+	auto r = in.read_record(this->record, this->data_size);
+
+	decoder d{in, *this, nullptr};
+	dispatch_element_type(r.type, d);
+	return std::move(d.e);
+}
+
+void element_view::accept(const_visitor& v)const{
+	this->decode()->accept(v);
+}
+
+snapshot_view::snapshot_view(utki::span<const uint8_t> data, uint64_t source_key) :
+		data(data)
+{
+	this->init(source_key);
+}
+
+snapshot_view::snapshot_view(const std::string& path, uint64_t source_key) :
+		file(std::make_unique<mapped_file>(path))
+{
+	auto s = this->file->span();
+	this->data = utki::make_span(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+	this->init(source_key);
+}
+
+snapshot_view::snapshot_view(snapshot_view&&) = default;
+
+snapshot_view& snapshot_view::operator=(snapshot_view&&) = default;
+
+snapshot_view::~snapshot_view()noexcept{}
+
+void snapshot_view::init(uint64_t source_key){
+	if(reinterpret_cast<uintptr_t>(this->data.data()) % alignof(real) != 0){
+		throw snapshot_error("snapshot data is not aligned");
+	}
+
+	snapshot_input in(this->data);
+	this->root_record = read_snapshot_header(in, source_key);
+
+	auto r = in.read_record(this->root_record, this->data.size());
+	if(r.type != element_type::svg){
+		throw snapshot_error("snapshot root element is not 'svg'");
+	}
+	if(this->root_record + r.size != this->data.size()){
+		throw snapshot_error("snapshot contains extra data after root element");
+	}
+}
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iterator>
+#include <cstdint>
+
+#include <utki/span.hpp>
+
+#include "snapshot.hpp"
+#include "elements/element_type.hpp"
+
+namespace svgdom{
+
+class const_visitor;
+class mapped_file;
+
+/**
+ * @brief Read-only view of an element stored in a binary snapshot.
+ * The view is a lightweight handle which reads the element's data directly from the snapshot
+ * memory, without creating element objects. It is valid as long as the snapshot memory is valid.
+ * All the accessors are bounds checked and throw snapshot_error in case the snapshot is corrupted.
+ */
+class element_view{
+	const uint8_t* data = nullptr;
+	size_t data_size = 0;
+	size_t record = 0;
+
+	// returns absolute offset of the attribute group, 0 if element does not have the group
+	size_t group_offset(size_t field_offset)const;
+
+	style_value find_style_value(size_t style_map_index, style_property p)const;
+
+	template <class T> class decoded_element;
+
+	struct decoder;
+
+	// decodes element to temporary object, children of container element are decoded when it accepts a visitor
+	std::unique_ptr<element> decode()const;
+
+public:
+	element_view() = default;
+
+	element_view(utki::span<const uint8_t> data, size_t record) :
+			data(data.data()),
+			data_size(data.size()),
+			record(record)
+	{}
+
+	/**
+	 * @brief Iterator over child elements.
+	 */
+	class const_iterator{
+		friend class element_view;
+
+		const uint8_t* data = nullptr;
+		size_t data_size = 0;
+		size_t record = 0;
+		size_t end = 0;
+
+		const_iterator(const uint8_t* data, size_t data_size, size_t record, size_t end);
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef element_view value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef void pointer;
+		typedef element_view reference;
+
+		const_iterator() = default;
+
+		element_view operator*()const noexcept{
+			return element_view(utki::make_span(this->data, this->data_size), this->record);
+		}
+
+		const_iterator& operator++();
+
+		const_iterator operator++(int){
+			auto ret = *this;
+			++(*this);
+			return ret;
+		}
+
+		bool operator==(const const_iterator& i)const noexcept{
+			return this->record == i.record;
+		}
+
+		bool operator!=(const const_iterator& i)const noexcept{
+			return this->record != i.record;
+		}
+	};
+
+	/**
+	 * @brief Child elements.
+	 */
+	class children_range{
+		friend class element_view;
+
+		const_iterator b;
+		const_iterator e;
+
+		children_range(const_iterator b, const_iterator e) :
+				b(b),
+				e(e)
+		{}
+	public:
+		const_iterator begin()const noexcept{
+			return this->b;
+		}
+
+		const_iterator end()const noexcept{
+			return this->e;
+		}
+
+		bool empty()const noexcept{
+			return this->b == this->e;
+		}
+	};
+
+	/**
+	 * @brief Get element type.
+	 * @return type of the element.
+	 */
+	element_type type()const;
+
+	/**
+	 * @brief Get element id.
+	 * @return id of the element, points to the snapshot memory.
+	 */
+	std::string_view id()const;
+
+	/**
+	 * @brief Get child elements.
+	 * Elements which are not containers have no children.
+	 * @return range of child elements.
+	 */
+	children_range children()const;
+
+	/**
+	 * @brief Get style property value from 'style' attribute.
+	 * @param p - style property to get.
+	 * @return value of the style property.
+	 * @return invalid value, see is_valid(), if element does not have the property in its 'style' attribute or is not styleable.
+	 */
+	style_value get_style_property(style_property p)const;
+
+	/**
+	 * @brief Get presentation attribute value.
+	 * @param p - style property to get.
+	 * @return value of the presentation attribute.
+	 * @return invalid value, see is_valid(), if element does not have the presentation attribute or is not styleable.
+	 */
+	style_value get_presentation_attribute(style_property p)const;
+
+	/**
+	 * @brief Get transformations.
+	 * @return transformations of the element, empty if element is not transformable.
+	 */
+	std::vector<transformable::transformation> get_transformations()const;
+
+	/**
+	 * @brief Get rectangle attributes, i.e. 'x', 'y', 'width' and 'height'.
+	 * @return rectangle attributes, default values if element does not have the attributes.
+	 */
+	rectangle get_rectangle()const;
+
+	/**
+	 * @brief Get 'viewBox' attribute.
+	 * @return view box, unspecified view box if element does not have the attribute, see view_boxed.
+	 */
+	decltype(view_boxed::view_box) get_view_box()const;
+
+	/**
+	 * @brief Get referenced IRI, i.e. 'xlink:href' attribute.
+	 * @return referenced IRI, points to the snapshot memory. Empty if element is not referencing.
+	 */
+	std::string_view get_iri()const;
+
+	/**
+	 * @brief Length attributes specific to element types.
+	 */
+	enum class length_attribute{
+		rx, // rect, ellipse
+		ry, // rect, ellipse
+		cx, // circle, ellipse, radialGradient
+		cy, // circle, ellipse, radialGradient
+		r, // circle, radialGradient
+		fx, // radialGradient
+		fy, // radialGradient
+		x1, // line, linearGradient
+		y1, // line, linearGradient
+		x2, // line, linearGradient
+		y2 // line, linearGradient
+	};
+
+	/**
+	 * @brief Get length attribute specific to element type.
+	 * @param a - attribute to get.
+	 * @return value of the attribute.
+	 * @return length(0, length_unit::unknown) if element does not have the attribute.
+	 */
+	length get_length(length_attribute a)const;
+
+	/**
+	 * @brief Get path commands.
+	 * @return path command bytes, see path_element::packed_path::commands(), empty if element is not a path.
+	 * @throw snapshot_error - in case the snapshot contains invalid command byte.
+	 */
+	utki::span<const uint8_t> get_path_commands()const;
+
+	/**
+	 * @brief Get path coordinates.
+	 * @return path coordinates, see path_element::packed_path::coordinates(), empty if element is not a path.
+	 */
+	utki::span<const real> get_path_coordinates()const;
+
+	/**
+	 * @brief Get polyline or polygon points.
+	 * @return coordinates of the points, x and y of each point one after another.
+	 *         Empty if element is neither polyline nor polygon.
+	 */
+	utki::span<const real> get_points()const;
+
+	/**
+	 * @brief Traverse the element with const_visitor.
+	 * The element is decoded to a temporary object which is passed to the visitor.
+	 * Children of decoded container element are decoded to temporary objects when the container
+	 * accepts a visitor, and are freed when the visiting of the container ends. So, visitors see the
+	 * actual children in the container, and the children decode their own children in turn when
+	 * they accept a visitor, either constant or not. Children of a child which has not accepted
+	 * the visitor yet are not decoded, so its container is empty. The whole document tree is never built,
+	 * only the elements on the path to the currently visited element and their siblings are decoded at a time.
+	 * @param v - visitor to accept.
+	 */
+	void accept(const_visitor& v)const;
+};
+
+/**
+ * @brief Read-only view of binary snapshot.
+ * Allows accessing the document stored in a snapshot, see save_snapshot(), without loading it,
+ * for example directly from a memory mapped file. Several processes mapping the same snapshot
+ * file share the same physical memory through the page cache.
+ */
+class snapshot_view{
+	std::unique_ptr<mapped_file> file;
+
+	utki::span<const uint8_t> data;
+	size_t root_record;
+
+	void init(uint64_t source_key);
+public:
+	/**
+	 * @brief Create view of snapshot in memory.
+	 * The memory must stay valid and unchanged for the lifetime of the view and all element views obtained from it.
+	 * @param data - snapshot data, must be aligned to alignof(real).
+	 * @param source_key - expected source key of the snapshot, see save_snapshot().
+	 * @throw snapshot_error - in case the snapshot header is invalid, is of incompatible version,
+	 *                         or has different source key, or the data is not aligned.
+	 */
+	snapshot_view(utki::span<const uint8_t> data, uint64_t source_key = 0);
+
+	/**
+	 * @brief Create view of snapshot file.
+	 * The file is mapped to memory for the lifetime of the view.
+	 * @param path - path to snapshot file in local file system.
+	 * @param source_key - expected source key of the snapshot, see save_snapshot().
+	 * @throw snapshot_error - in case the snapshot header is invalid, is of incompatible version,
+	 *                         or has different source key.
+	 * @throw std::system_error - in case the file could not be opened or mapped.
+	 */
+	snapshot_view(const std::string& path, uint64_t source_key = 0);
+
+	snapshot_view(const snapshot_view&) = delete;
+	snapshot_view& operator=(const snapshot_view&) = delete;
+
+	snapshot_view(snapshot_view&&);
+	snapshot_view& operator=(snapshot_view&&);
+
+	~snapshot_view()noexcept;
+
+	/**
+	 * @brief Get root element.
+	 * @return view of the root 'svg' element.
+	 */
+	element_view root()const noexcept{
+		return element_view(this->data, this->root_record);
+	}
+};
+
+}
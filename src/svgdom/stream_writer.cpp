@@ -9,71 +9,108 @@
 
 using namespace svgdom;
 
+namespace{
+// stream without buffer, discards everything written to it
+std::ostream& null_stream(){
+	static std::ostream s(nullptr);
+	return s;
+}
+}
+
+stream_writer::stream_writer(std::ostream& s) :
+		out(this->buffer),
+		s(s)
+{}
+
+stream_writer::stream_writer(std::string& out) :
+		out(out),
+		s(null_stream())
+{}
+
 void stream_writer::set_name(const std::string& name) {
 	this->name = name;
 }
 
+std::string& stream_writer::begin_attribute(const std::string& name){
+	this->attributes += ' ';
+	this->attributes += name;
+	this->attributes += "=\"";
+	return this->attributes;
+}
+
+void stream_writer::end_attribute(){
+	this->attributes += '"';
+}
+
 void stream_writer::add_attribute(const std::string& name, const std::string& value) {
-	this->attributes.push_back(std::make_pair(name, value));
+	this->begin_attribute(name) += value;
+	this->end_attribute();
 }
 
 void stream_writer::add_attribute(const std::string& name, const length& value){
-	std::stringstream ss;
-	ss << value;
-	this->add_attribute(name, ss.str());
+	append_length(this->begin_attribute(name), value);
+	this->end_attribute();
 }
 
 void stream_writer::add_attribute(const std::string& name, real value){
-	std::stringstream ss;
-	ss << value;
-	this->add_attribute(name, ss.str());
+	append_real(this->begin_attribute(name), value);
+	this->end_attribute();
 }
 
 void stream_writer::write(const container* children, const std::string& content){
-	auto ind = indent_str();
+	auto& o = this->out;
 
-	auto tag = std::move(this->name);
-	
-	this->s << ind << "<" << tag;
-	
-	for(auto& a : this->attributes){
-		this->s << " " << a.first << "=\"" << a.second << "\"";
-	}
+	o.append(this->indent, '\t');
+	o += '<';
+	o += this->name;
+	o += this->attributes;
 
 	this->attributes.clear();
-	this->name.clear();
 	
 	if((!children || children->children.size() == 0) && content.empty()){
-		this->s << "/>";
+		o += "/>\n";
+		this->name.clear();
 	}else{
-		this->s << ">" << std::endl;
+		o += ">\n";
 		if(children){
+			// children overwrite the name, so save it for the closing tag
+			auto tag = std::move(this->name);
+			this->name.clear();
 			this->childrenToStream(*children);
+			this->name = std::move(tag);
 		}
-		this->s << content;
-		this->s << ind << "</" << tag << ">";
+		o += content;
+		o.append(this->indent, '\t');
+		o += "</";
+		o += this->name;
+		o += ">\n";
+		this->name.clear();
 	}
-	this->s << std::endl;
-}
 
-std::string stream_writer::indent_str(){
-	std::string ind;
+	this->flush();
+}
 
-	std::stringstream ss;
-	for(unsigned i = 0; i != this->indent; ++i){
-		ss << "\t";
+void stream_writer::flush(){
+	if(&this->out != &this->buffer || this->buffer.empty()){
+		return;
 	}
-	return ss.str();
+	this->s.write(this->buffer.data(), this->buffer.size());
+	this->buffer.clear();
+}
+
+std::string stream_writer::indent_str(){
+	return std::string(this->indent, '\t');
 }
 
 void stream_writer::childrenToStream(const container& e){
+	// derived classes may write to the stream directly when visiting children
+	this->flush();
+
 	++this->indent;
 	utki::scope_exit scope_exit([this](){
 		--this->indent;
 	});
-	for (auto& c : e.children) {
-		c->accept(*this);
-	}
+	this->relay_accept(e);
 }
 
 void stream_writer::add_element_attributes(const element& e){
@@ -84,29 +121,34 @@ void stream_writer::add_element_attributes(const element& e){
 
 void stream_writer::add_transformable_attributes(const transformable& e){
 	if(e.transformations.size() != 0){
-		this->add_attribute("transform", e.transformations_to_string());
+		e.append_transformations(this->begin_attribute("transform"));
+		this->end_attribute();
 	}
 }
 
 void stream_writer::add_styleable_attributes(const styleable& e){
 	if(!e.styles.empty()){
-		this->add_attribute("style", e.styles_to_string());
+		e.append_styles(this->begin_attribute("style"));
+		this->end_attribute();
 	}
 	for(auto& s : e.presentation_attributes){
 		auto n = styleable::property_to_string(s.first);
 		if(n.empty()){ // unknown property
 			continue;
 		}
-		this->add_attribute(n, styleable::style_value_to_string(s.first, s.second));
+		styleable::append_style_value(this->begin_attribute(n), s.first, s.second);
+		this->end_attribute();
 	}
 	if(!e.classes.empty()){
-		this->add_attribute("class", e.classes_to_string());
+		e.append_classes(this->begin_attribute("class"));
+		this->end_attribute();
 	}
 }
 
 void stream_writer::add_view_boxed_attributes(const view_boxed& e){
 	if(e.is_view_box_specified()){
-		this->add_attribute("viewBox", e.view_box_to_string());
+		e.append_view_box(this->begin_attribute("viewBox"));
+		this->end_attribute();
 	}
 }
 
@@ -154,7 +196,8 @@ void stream_writer::add_gradient_attributes(const gradient& e){
 	}
 	
 	if(e.transformations.size() != 0){
-		this->add_attribute("gradientTransform", e.transformations_to_string());
+		e.append_transformations(this->begin_attribute("gradientTransform"));
+		this->end_attribute();
 	}
 }
 
@@ -303,7 +346,8 @@ void stream_writer::visit(const polygon_element& e) {
 	this->set_name(polygon_element::tag);
 	this->add_shape_attributes(e);
 	if(e.points.size() != 0){
-		this->add_attribute("points", e.points_to_string());
+		e.append_points(this->begin_attribute("points"));
+		this->end_attribute();
 	}
 	this->write();
 }
@@ -312,7 +356,8 @@ void stream_writer::visit(const polyline_element& e) {
 	this->set_name(polyline_element::tag);
 	this->add_shape_attributes(e);
 	if(e.points.size() != 0){
-		this->add_attribute("points", e.points_to_string());
+		e.append_points(this->begin_attribute("points"));
+		this->end_attribute();
 	}
 	this->write();
 }
@@ -339,7 +384,8 @@ void stream_writer::visit(const path_element& e){
 	this->set_name(path_element::tag);
 	this->add_shape_attributes(e);
 	if(e.path.size() != 0){
-		this->add_attribute("d", e.path_to_string());
+		e.append_path(this->begin_attribute("d"));
+		this->end_attribute();
 	}
 	this->write();
 }
@@ -458,14 +504,18 @@ void stream_writer::visit(const style_element& e){
 
 	auto css_vec = fi.reset_data();
 
-	std::stringstream ss;
+	std::string content;
 	if(!css_vec.empty()){
-		ss << ind << cdata_open << std::endl;
-		ss << utki::make_string(css_vec);
-		ss << ind << cdata_close << std::endl;
+		content += ind;
+		content += cdata_open;
+		content += '\n';
+		content.append(reinterpret_cast<const char*>(css_vec.data()), css_vec.size());
+		content += ind;
+		content += cdata_close;
+		content += '\n';
 	}
 
-	this->write(nullptr, ss.str());
+	this->write(nullptr, content);
 }
 
 void stream_writer::visit(const text_element& e){
@@ -563,15 +613,11 @@ void stream_writer::visit(const fe_color_matrix_element& e){
 			default:
 			case fe_color_matrix_element::type::matrix:
 				// write 20 values
-				{
-					std::stringstream ss;
-					for(unsigned i = 0; i != e.values.size(); ++i){
-						if(i != 0){
-							ss << " ";
-						}
-						ss << e.values[i];
+				for(unsigned i = 0; i != e.values.size(); ++i){
+					if(i != 0){
+						valuesValue += ' ';
 					}
-					valuesValue = ss.str();
+					append_real(valuesValue, e.values[i]);
 				}
 				break;
 			case fe_color_matrix_element::type::hue_rotate:
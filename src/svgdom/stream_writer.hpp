@@ -1,15 +1,40 @@
 #pragma once
 
+#include <ostream>
+#include <string>
+
 #include "visitor.hpp"
 
 namespace svgdom{
 
+/**
+ * @brief Visitor which writes SVG document as XML.
+ * The output is composed directly in a contiguous character buffer, without intermediate strings
+ * and without formatting through std::ostream. When writing to a stream, the buffered output is
+ * written to the stream once per element, so that content written directly to the stream
+ * by the derived classes goes to the right place.
+ */
 class stream_writer : virtual public const_visitor{
 private:
 	void childrenToStream(const container& e);
+
+	// write buffered output to the stream, does nothing when writing to string
+	void flush();
 	
 	std::string name;
-	std::vector<std::pair<std::string, std::string>> attributes;
+
+	// attributes of the element being written, in form of ' name="value"' one after another
+	std::string attributes;
+
+	// buffer for the output when writing to stream
+	std::string buffer;
+
+	// output buffer, either the 'buffer' or the string given to constructor
+	std::string& out;
+
+	// starts attribute in the 'attributes' and returns it for appending the attribute value
+	std::string& begin_attribute(const std::string& name);
+	void end_attribute();
 protected:
 	// s, indent, and indentStr() are made protected to allow writing arbitrary content to stream for those who extend the class, as this was needed in some projects.
 	std::ostream& s;
@@ -45,7 +70,23 @@ protected:
 	void add_text_positioning_attributes(const text_positioning& e);
 	
 public:
-	stream_writer(std::ostream& s) : s(s) {}
+	/**
+	 * @brief Create writer to stream.
+	 * @param s - stream to write the document to.
+	 */
+	stream_writer(std::ostream& s);
+
+	/**
+	 * @brief Create writer to string.
+	 * The document is appended to the string. This is faster than writing to stream.
+	 * The stream 's' available to derived classes is not connected to the string, anything
+	 * written to the stream is discarded.
+	 * @param out - string to append the document to.
+	 */
+	stream_writer(std::string& out);
+
+	stream_writer(const stream_writer&) = delete;
+	stream_writer& operator=(const stream_writer&) = delete;
 	
 	void visit(const g_element& e) override;
 	void visit(const svg_element& e) override;
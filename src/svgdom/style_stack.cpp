@@ -6,9 +6,12 @@
 
 using namespace svgdom;
 
-style_stack::crawler::crawler(decltype(stack) stack) :
-		stack(stack)
-{}
+style_stack::crawler::crawler(decltype(stack) stack, size_t level) :
+		stack(stack),
+		start(std::next(stack.rbegin(), stack.size() - 1 - level))
+{
+	ASSERT(level < stack.size())
+}
 
 const cssdom::styleable& style_stack::crawler::get(){
 	ASSERT(!this->stack.empty())
@@ -37,57 +40,110 @@ void style_stack::crawler::reset(){
 		throw std::logic_error("style_stack::crawler::reset(): stack is empty");
 	}
 
-	this->iter = this->stack.rbegin();
+	this->iter = this->start;
 }
 
-const svgdom::style_value* style_stack::get_style_property(svgdom::style_property p)const{
-	bool explicit_inherit = false;
-
-	for(auto i = this->stack.rbegin(); i != this->stack.rend(); ++i){
-		auto v = i->get().get_style_property(p);
-		if(!v){
-			v = this->get_css_style_property(p);
-			if(!v){
-				v = i->get().get_presentation_attribute(p);
-				if(!v){
-					if(!explicit_inherit && !svgdom::styleable::is_inherited(p)){
-						return nullptr;
-					}
-					continue;
+const svgdom::style_value* style_stack::get_own_style_property(size_t level, svgdom::style_property p)const{
+	auto& s = this->stack[level].get();
+	if(auto v = s.get_style_property(p)){
+		return v;
+	}
+	if(auto v = this->get_css_style_property(level, p)){
+		return v;
+	}
+	return s.get_presentation_attribute(p);
+}
+
+const svgdom::style_value* style_stack::resolve_style_property(size_t level, svgdom::style_property p)const{
+	ASSERT(level < this->stack.size())
+	ASSERT(level < this->cache.size())
+
+	auto& c = this->cache[level];
+	if(c.is_resolved[size_t(p)]){
+		return c.values[size_t(p)];
+	}
+
+	const style_value* ret = nullptr;
+
+	auto v = this->get_own_style_property(level, p);
+	if(v && !is_inherit(*v)){
+		ret = v;
+	}else if(level != 0){
+		if(svgdom::styleable::is_inherited(p)){
+			ret = this->resolve_style_property(level - 1, p);
+		}else if(v){
+			// explicitly inherited non-inherited property, take the closest ancestor's value
+			for(size_t i = level; i != 0;){
+				--i;
+				auto av = this->get_own_style_property(i, p);
+				if(av && !is_inherit(*av)){
+					ret = av;
+					break;
 				}
 			}
 		}
-		ASSERT(v)
-		if(is_inherit(*v)){
-			explicit_inherit = true;
-			continue;
-		}
-		return v;
 	}
 
-	return nullptr;
+	c.is_resolved.set(size_t(p));
+	c.values[size_t(p)] = ret;
+	return ret;
+}
+
+const svgdom::style_value* style_stack::get_style_property(svgdom::style_property p)const{
+	if(this->stack.empty()){
+		return nullptr;
+	}
+
+	if(this->cache.size() < this->stack.size()){
+		this->cache.resize(this->stack.size());
+	}
+
+	return this->resolve_style_property(this->stack.size() - 1, p);
 }
 
 style_stack::push::push(style_stack& ss, const svgdom::styleable& s) :
 		ss(ss)
 {
+	// drop stale cache levels, if any
+	if(this->ss.cache.size() > this->ss.stack.size()){
+		this->ss.cache.resize(this->ss.stack.size());
+	}
 	this->ss.stack.push_back(s);
 }
 
 style_stack::push::~push()noexcept{
 	this->ss.stack.pop_back();
+	if(this->ss.cache.size() > this->ss.stack.size()){
+		this->ss.cache.resize(this->ss.stack.size());
+	}
 }
 
 void style_stack::add_css(const cssdom::document& css_doc){
-	this->css.push_back(css_doc);
+	auto index = std::make_shared<css_selector_index>(css_doc);
+	this->css.push_back(css_document{css_doc, *index, index});
+	this->cache.clear();
 }
 
-const style_value* style_stack::get_css_style_property(style_property p)const{
-	crawler c(this->stack);
+void style_stack::add_css(const style_element& e){
+	if(!e.selector_index.is_valid_for(e.css)){
+		this->add_css(e.css);
+		return;
+	}
+	this->css.push_back(css_document{e.css, e.selector_index, nullptr});
+	this->cache.clear();
+}
+
+const style_value* style_stack::get_css_style_property(size_t level, style_property p)const{
+	if(this->css.empty()){
+		return nullptr;
+	}
+	crawler c(this->stack, level);
 	unsigned specificity = 0;
 	const style_value* ret = nullptr;
 	for(auto& ss : this->css){
-		auto r = ss.get().get_property_value(c, uint32_t(p));
+		auto& doc = ss.doc.get();
+		auto& index = ss.index.get();
+		auto r = index.get_property_value(doc, c, uint32_t(p));
 		if(!r.value){
 			continue;
 		}
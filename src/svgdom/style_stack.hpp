@@ -1,11 +1,15 @@
 #pragma once
 
 #include <vector>
+#include <array>
+#include <bitset>
+#include <memory>
 
 #include <cssdom/dom.hpp>
 
 #include "elements/styleable.hpp"
 #include "elements/container.hpp"
+#include "elements/style.hpp"
 
 namespace svgdom{
 class style_stack{
@@ -13,15 +17,27 @@ public:
 	std::vector<std::reference_wrapper<const styleable>> stack;
 
 private:
-	std::vector<std::reference_wrapper<const cssdom::document>> css;
+	struct css_document{
+		std::reference_wrapper<const cssdom::document> doc;
+		std::reference_wrapper<const css_selector_index> index;
+		std::shared_ptr<const css_selector_index> own_index; // set if the index was built by style_stack
+	};
+
+	std::vector<css_document> css;
 
 	class crawler : public cssdom::xml_dom_crawler{
 		const decltype(style_stack::stack)& stack;
 
+		std::remove_reference<decltype(stack)>::type::const_reverse_iterator start;
 		std::remove_reference<decltype(stack)>::type::const_reverse_iterator iter;
 
 	public:
-		crawler(decltype(stack) stack);
+		/**
+		 * @brief Constructor.
+		 * @param stack - style stack to crawl.
+		 * @param level - index of the stack element to start crawling from.
+		 */
+		crawler(decltype(stack) stack, size_t level);
 
 		const cssdom::styleable& get()override;
 
@@ -30,12 +46,48 @@ private:
 		void reset()override;
 	};
 
-	const svgdom::style_value* get_css_style_property(svgdom::style_property p)const;
+	const svgdom::style_value* get_css_style_property(size_t level, svgdom::style_property p)const;
+
+	// resolved style property values for each stack level
+	struct cache_level{
+		std::bitset<size_t(style_property::ENUM_SIZE)> is_resolved;
+		std::array<const style_value*, size_t(style_property::ENUM_SIZE)> values;
+	};
+
+	// grows lazily as properties are resolved, levels above stack size are stale
+	mutable std::vector<cache_level> cache;
+
+	const svgdom::style_value* get_own_style_property(size_t level, svgdom::style_property p)const;
+	const svgdom::style_value* resolve_style_property(size_t level, svgdom::style_property p)const;
 public:
+	/**
+	 * @brief Get computed style property value for the element on top of the stack.
+	 * Resolved values are cached per stack level, so repeated queries, also the ones
+	 * for properties inherited from ancestors, are cheap.
+	 * The cache assumes that styleables on the stack are not modified while
+	 * they are on the stack, and that the stack is changed only via style_stack::push.
+	 * @param p - style property to get.
+	 * @return pointer to style property value.
+	 * @return nullptr if the style property is not set.
+	 */
 	const svgdom::style_value* get_style_property(svgdom::style_property p)const;
 	
+	/**
+	 * @brief Add CSS document.
+	 * Builds selector index for the document.
+	 * @param css_doc - CSS document to add. Must outlive the style stack.
+	 */
 	void add_css(const cssdom::document& css_doc);
 
+	/**
+	 * @brief Add CSS document of the style element.
+	 * Uses selector index of the style element, if it is up to date, otherwise
+	 * builds the index as add_css(const cssdom::document&) does.
+	 * The CSS document must not be changed while it is added to the style stack.
+	 * @param e - style element to add CSS document of. Must outlive the style stack.
+	 */
+	void add_css(const style_element& e);
+
 	class push{
 		style_stack& ss;
 	public:
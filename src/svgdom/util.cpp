@@ -2,6 +2,17 @@
 
 #include <sstream>
 #include <cctype>
+#include <cmath>
+#include <stdexcept>
+#include <cstring>
+#include <charconv>
+#include <locale>
+
+#include <utki/debug.hpp>
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#endif
 
 using namespace svgdom;
 
@@ -63,105 +74,336 @@ std::string svgdom::read_till_char_or_whitespace(std::istream& s, char c){
 }
 
 
+char string_parser::peek_char()const{
+	if(this->view.empty()){
+		throw std::invalid_argument("string_parser::peek_char(): end of string reached");
+	}
+	return this->view.front();
+}
+
+char string_parser::read_char(){
+	auto ret = this->peek_char();
+	this->view.remove_prefix(1);
+	return ret;
+}
+
+void string_parser::skip_whitespaces(){
+	size_t i = 0;
+	for(; i != this->view.size(); ++i){
+		if(!is_whitespace(this->view[i])){
+			break;
+		}
+	}
+	this->view.remove_prefix(i);
+}
+
+void string_parser::skip_whitespaces_and_comma(){
+	bool comma_skipped = false;
+	size_t i = 0;
+	for(; i != this->view.size(); ++i){
+		auto c = this->view[i];
+		if(is_whitespace(c)){
+			continue;
+		}else if(c == ',' && !comma_skipped){
+			comma_skipped = true;
+			continue;
+		}
+		break;
+	}
+	this->view.remove_prefix(i);
+}
+
+void string_parser::skip_inclusive_until(char c){
+	auto i = this->view.find(c);
+	if(i == std::string_view::npos){
+		this->view.remove_prefix(this->view.size());
+		return;
+	}
+	this->view.remove_prefix(i + 1);
+}
+
+std::string_view string_parser::read_chars_until(char c){
+	auto i = this->view.find(c);
+	if(i == std::string_view::npos){
+		i = this->view.size();
+	}
+	auto ret = this->view.substr(0, i);
+	this->view.remove_prefix(i);
+	return ret;
+}
+
+std::string_view string_parser::read_word(){
+	size_t i = 0;
+	for(; i != this->view.size(); ++i){
+		if(is_whitespace(this->view[i])){
+			break;
+		}
+	}
+	auto ret = this->view.substr(0, i);
+	this->view.remove_prefix(i);
+	return ret;
+}
+
+std::string_view string_parser::read_word_until(char c){
+	size_t i = 0;
+	for(; i != this->view.size(); ++i){
+		auto ch = this->view[i];
+		if(ch == c || is_whitespace(ch)){
+			break;
+		}
+	}
+	auto ret = this->view.substr(0, i);
+	this->view.remove_prefix(i);
+	return ret;
+}
+
 namespace{
-std::string readInNumberString(std::istream& s){
-	std::stringstream ss;
-	
-	bool sign = false;
-	bool expSign = false;
-	bool exponent = false;
-	bool dot = false;
-	bool validNumber = false;
-	
-	while(!s.eof()){
-		auto c = char(s.peek());
-//		TRACE(<< "c = " << char(c) << std::endl)
-		switch(c){
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
-				sign = true;
-				if(exponent){
-					expSign = true;
-				}
-				validNumber = true;
-				break;
-			case '+':
-			case '-':
-				if(sign){
-					if(expSign){
-						return ss.str();
-					}
-					expSign = true;
-					if(!exponent){
-						return ss.str();
-					}
-				}
-				sign = true;
-				break;
-			case 'e':
-			case 'E':
-				sign = true;
-				if(exponent){
-					return ss.str();
-				}
-				exponent = true;
-				break;
-			case '.':
-				if(dot || exponent){
-					return ss.str();
-				}
-				sign = true;
-				dot = true;
-				break;
-			default:
-				if(!validNumber){
-					//WORKAROUND: if no valid number was read then we need to leave stream in failed state
-					//to do that, try to read in the float number (we know it should fail since no valid number detected on stream).
-					float x;
-					s >> x;
+constexpr bool is_digit(char c)noexcept{
+	return '0' <= c && c <= '9';
+}
+
+// powers of 10 which are exactly representable by double
+const std::array<double, 23> exact_powers_of_10 = {{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+}};
+
+// significant digits are accumulated while mantissa is less than this value, so that it fits into uint64_t
+const uint64_t max_mantissa = 100000000000000000; // 10^17
+
+#if defined(_MSC_VER) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+// Digits are classified and converted 8 at a time within a 64-bit word (SWAR),
+// which needs characters to be loaded in little-endian order.
+#	define SVGDOM_SWAR_DIGITS
+
+// Up to 8 digits can be added at once while mantissa is less than this value,
+// then every digit is accumulated, same as when adding digits one by one.
+const uint64_t max_swar_mantissa = 1000000000; // 10^9
+
+const std::array<uint64_t, 9> powers_of_10 = {{
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+}};
+
+uint64_t load_8_chars(const char* p)noexcept{
+	uint64_t ret;
+	std::memcpy(&ret, p, sizeof(ret));
+	return ret;
+}
+
+// returns number of leading digit characters, from 0 to 8
+unsigned count_leading_digits(uint64_t chars)noexcept{
+	// for digit character high nibble is 3 and it stays 3 after adding 6 to low nibble,
+	// carries between bytes only happen for non-digit characters and only affect following characters
+	auto x = (chars & 0xf0f0f0f0f0f0f0f0) | (((chars + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4);
+	auto non_digits = x ^ 0x3333333333333333;
+	if(non_digits == 0){
+		return 8;
+	}
+#	if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, non_digits);
+	return unsigned(index) / 8;
+#	else
+	return unsigned(__builtin_ctzll(non_digits)) / 8;
+#	endif
+}
+
+// converts leading num_digits digit characters to number, num_digits must be from 1 to 8
+uint64_t parse_leading_digits(uint64_t chars, unsigned num_digits)noexcept{
+	// shift the digits to the end of the word, the vacated characters become leading zeros
+	chars <<= 8 * (8 - num_digits);
+
+	chars = ((chars & 0x0f0f0f0f0f0f0f0f) * 2561) >> 8;
+	chars = ((chars & 0x00ff00ff00ff00ff) * 6553601) >> 16;
+	return ((chars & 0x0000ffff0000ffff) * 42949672960001) >> 32;
+}
+
+// reads a run of up to 8 digits at once, returns number of digits read
+unsigned read_digits(const char* p, const char* end, uint64_t& mantissa)noexcept{
+	if(end - p < 8 || mantissa >= max_swar_mantissa){
+		return 0;
+	}
+	auto chars = load_8_chars(p);
+	auto n = count_leading_digits(chars);
+	if(n != 0){
+		mantissa = mantissa * powers_of_10[n] + parse_leading_digits(chars, n);
+	}
+	return n;
+}
+#endif
+}
+
+real string_parser::read_real(){
+	auto ret = this->try_read_real();
+	if(!ret){
+		throw std::invalid_argument("string_parser::read_real(): no number found");
+	}
+	return *ret;
+}
+
+std::optional<real> string_parser::try_read_real()noexcept{
+	auto p = this->view.data();
+	auto end = p + this->view.size();
+
+	for(; p != end && is_whitespace(*p); ++p){}
+
+	bool negative = false;
+	if(p != end && (*p == '-' || *p == '+')){
+		negative = *p == '-';
+		++p;
+	}
+
+	uint64_t mantissa = 0;
+	int exponent = 0;
+	bool has_digits = false;
+
+#ifdef SVGDOM_SWAR_DIGITS
+	for(unsigned n = 8; n == 8;){
+		n = read_digits(p, end, mantissa);
+		p += n;
+		has_digits |= n != 0;
+	}
+#endif
+
+	// remaining digits one by one
+	for(; p != end && is_digit(*p); ++p){
+		has_digits = true;
+		if(mantissa < max_mantissa){
+			mantissa = mantissa * 10 + uint64_t(*p - '0');
+		}else{
+			++exponent; // digit does not fit into mantissa, drop it
+		}
+	}
+
+	if(p != end && *p == '.'){
+		++p;
+#ifdef SVGDOM_SWAR_DIGITS
+		for(unsigned n = 8; n == 8;){
+			n = read_digits(p, end, mantissa);
+			p += n;
+			exponent -= int(n);
+			has_digits |= n != 0;
+		}
+#endif
+		for(; p != end && is_digit(*p); ++p){
+			has_digits = true;
+			if(mantissa < max_mantissa){
+				mantissa = mantissa * 10 + uint64_t(*p - '0');
+				--exponent;
+			}
+		}
+	}
+
+	if(!has_digits){
+		return std::nullopt;
+	}
+
+	if(p != end && (*p == 'e' || *p == 'E')){
+		auto q = std::next(p);
+		bool exp_negative = false;
+		if(q != end && (*q == '-' || *q == '+')){
+			exp_negative = *q == '-';
+			++q;
+		}
+		if(q != end && is_digit(*q)){
+			int exp = 0;
+			for(; q != end && is_digit(*q); ++q){
+				if(exp < 100000){ // prevent int overflow, such big exponents give zero or infinity anyway
+					exp = exp * 10 + (*q - '0');
 				}
-				return ss.str();
+			}
+			exponent += exp_negative ? -exp : exp;
+			p = q;
 		}
-		ss << char(s.get());
 	}
-	return ss.str();
+
+	this->view.remove_prefix(size_t(p - this->view.data()));
+
+	// Mantissa of up to 15 decimal digits is exactly representable by double, then multiplying or
+	// dividing it by exact power of 10 gives correctly rounded result. Longer mantissas are rounded
+	// once more, which is still far beyond the precision of 'real'.
+	auto ret = double(mantissa);
+	if(mantissa == 0){
+		// zero stays zero regardless of the exponent, avoid 0 * inf
+	}else if(exponent < 0){
+		if(size_t(-exponent) < exact_powers_of_10.size()){
+			ret /= exact_powers_of_10[-exponent];
+		}else{
+			ret *= std::pow(10.0, exponent);
+		}
+	}else if(exponent > 0){
+		if(size_t(exponent) < exact_powers_of_10.size()){
+			ret *= exact_powers_of_10[exponent];
+		}else{
+			ret *= std::pow(10.0, exponent);
+		}
+	}
+
+	return real(negative ? -ret : ret);
 }
+
+// Floating point std::to_chars() is not available in older standard libraries, e.g. in libc++ of
+// older Xcode versions, those use a string stream instead.
+void svgdom::append_real(std::string& s, real x){
+#ifdef __cpp_lib_to_chars
+	// enough for 6 significant digits in exponential notation, e.g. "-1.23457e-308"
+	std::array<char, 32> buf;
+	auto res = std::to_chars(buf.data(), buf.data() + buf.size(), x, std::chars_format::general, 6);
+	ASSERT(res.ec == std::errc())
+	s.append(buf.data(), res.ptr);
+#else
+	thread_local std::ostringstream ss = [](){
+		std::ostringstream ret;
+		ret.imbue(std::locale::classic());
+		return ret;
+	}();
+	ss.str(std::string());
+	ss << x;
+	s += ss.str();
+#endif
 }
 
+void svgdom::append_length(std::string& s, const length& l){
+	append_real(s, l.value);
 
-real svgdom::read_in_real(std::istream& s) {
-	skip_whitespaces(s);
-	
-	//On MacOS reading in the number which is terminated by non-number and non-whitespace character,
-	//e.g. "0c" will result in stream error, i.e. s.fail() will return true and stream will be in unreadable state.
-	//To workaround this, need to read in the number to a separate string and parse it from there.
-	auto str = readInNumberString(s);
-	
-	if(str.length() == 0){
-		return 0;
+	switch(l.unit){
+		case length_unit::unknown:
+		case length_unit::number:
+		default:
+			break;
+		case length_unit::percent:
+			s += '%';
+			break;
+		case length_unit::em:
+			s += "em";
+			break;
+		case length_unit::ex:
+			s += "ex";
+			break;
+		case length_unit::px:
+			s += "px";
+			break;
+		case length_unit::cm:
+			s += "cm";
+			break;
+		case length_unit::mm:
+			s += "mm";
+			break;
+		case length_unit::in:
+			s += "in";
+			break;
+		case length_unit::pt:
+			s += "pt";
+			break;
+		case length_unit::pc:
+			s += "pc";
+			break;
 	}
-	
-	std::istringstream iss(str);
-	
-	//Visual Studio standard library fails to parse numbers to 'float' if it does not actually fit into 'float',
-	//for example, parsing of "5.47382e-48" to float fails instead of giving 0.
-	//To workaround this read in to the biggest precision type 'long double'.
-	long double x;
-	iss >> x;
-	return real(x);
 }
 
-std::string svgdom::trim_tail(const std::string& s){
+std::string_view svgdom::trim_tail(std::string_view s){
 	const auto t = s.find_last_not_of(" \t\n\r");
-	if(t == std::string::npos){
+	if(t == std::string_view::npos){
 		return s;
 	}
 	
@@ -176,7 +418,7 @@ std::string svgdom::iri_to_local_id(const std::string& iri){
 }
 
 
-coordinate_units svgdom::parse_coordinate_units(const std::string& s){
+coordinate_units svgdom::parse_coordinate_units(std::string_view s){
 	if(s == "userSpaceOnUse"){
 		return coordinate_units::user_space_on_use;
 	}else if(s == "objectBoundingBox"){
@@ -198,37 +440,39 @@ std::string svgdom::coordinate_units_to_string(coordinate_units u){
 }
 
 
-r4::vector2<real> svgdom::parse_number_and_optional_number(const std::string& s, r4::vector2<real> defaults){
+r4::vector2<real> svgdom::parse_number_and_optional_number(std::string_view s, r4::vector2<real> defaults){
 	r4::vector2<real> ret;
 	
-	std::istringstream ss(s);
-	skip_whitespaces(ss);
-	ret[0] = read_in_real(ss);
-	if(ss.fail()){
+	string_parser p(s);
+	try{
+		ret[0] = p.read_real();
+	}catch(std::invalid_argument&){
 		return defaults;
 	}
-	skip_whitespaces_and_comma(ss);
+	p.skip_whitespaces_and_comma();
 
-	if(ss.eof()){
+	if(p.empty()){
 		ret[1] = defaults[1];
 		return ret;
 	}
 	
-	ret[1] = read_in_real(ss);
-	if(ss.fail()){
+	try{
+		ret[1] = p.read_real();
+	}catch(std::invalid_argument&){
 		ret[1] = defaults[1];
 	}
 	return ret;
 }
 
 std::string svgdom::number_and_optional_number_to_string(std::array<real, 2> non, real optionalNumberDefault){
-	std::stringstream ss;
+	std::string ret;
 	
-	ss << non[0];
+	append_real(ret, non[0]);
 	
 	if(non[1] != optionalNumberDefault){
-		ss << " " << non[1];
+		ret += ' ';
+		append_real(ret, non[1]);
 	}
 	
-	return ss.str();
+	return ret;
 }
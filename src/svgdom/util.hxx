@@ -2,14 +2,127 @@
 
 #include <istream>
 #include <array>
+#include <string_view>
+#include <optional>
+#include <memory_resource>
 
 #include <r4/vector2.hpp>
 
 #include "config.hpp"
+#include "length.hpp"
 #include "elements/coordinate_units.hpp"
 
 namespace svgdom{
 
+/**
+ * @brief Check if character is a white space.
+ * Locale independent, recognizes same characters as std::isspace() in "C" locale.
+ * @param c - character to check.
+ * @return true if the character is a white space.
+ */
+constexpr bool is_whitespace(char c)noexcept{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * @brief Scanner over a string.
+ * Reads tokens and numbers directly from the character range without
+ * making any heap allocations and without using streams or locale.
+ * Methods which cannot read the requested item throw std::invalid_argument,
+ * in that case the scanner position is left unchanged.
+ * The try_ variants of the methods do not throw, instead they return std::nullopt
+ * and leave the scanner position unchanged.
+ */
+class string_parser{
+	std::string_view view;
+public:
+	string_parser(std::string_view view) :
+			view(view)
+	{}
+
+	bool empty()const noexcept{
+		return this->view.empty();
+	}
+
+	/**
+	 * @brief Get the rest of the string which is not parsed yet.
+	 * @return unparsed part of the string.
+	 */
+	std::string_view get_view()const noexcept{
+		return this->view;
+	}
+
+	char peek_char()const;
+
+	char read_char();
+
+	void skip_whitespaces();
+
+	void skip_whitespaces_and_comma();
+
+	void skip_inclusive_until(char c);
+
+	/**
+	 * @brief Read characters until given one or end of string.
+	 * @param c - character to stop at, it is not read.
+	 * @return read characters.
+	 */
+	std::string_view read_chars_until(char c);
+
+	/**
+	 * @brief Read characters until white space or end of string.
+	 * @return read characters.
+	 */
+	std::string_view read_word();
+
+	/**
+	 * @brief Read characters until given one, white space or end of string.
+	 * @param c - character to stop at, it is not read.
+	 * @return read characters.
+	 */
+	std::string_view read_word_until(char c);
+
+	/**
+	 * @brief Try to read real number.
+	 * Leading white spaces are skipped.
+	 * Number format is: [+|-]digits[.digits][(e|E)[+|-]digits].
+	 * The exponent part is only consumed if it has at least one digit, so that
+	 * units like "em" and "ex" following the number are not eaten.
+	 * Does not throw, so it is suitable for parsing long lists of numbers where
+	 * malformed input is not exceptional.
+	 * @return parsed number.
+	 * @return std::nullopt if there is no number at current position, in that case
+	 *         the position is left unchanged, i.e. leading white spaces are not skipped.
+	 */
+	std::optional<real> try_read_real()noexcept;
+
+	/**
+	 * @brief Read real number.
+	 * Same as try_read_real(), but throws in case there is no number.
+	 * @return parsed number.
+	 * @throw std::invalid_argument - in case there is no number at current position.
+	 */
+	real read_real();
+};
+
+/**
+ * @brief Append real number to string.
+ * The number is written with 6 significant digits, same as standard streams do by default.
+ * Locale independent. Where floating point std::to_chars() is available, does not use streams and
+ * makes no heap allocations except growing the string.
+ * @param s - string to append the number to.
+ * @param x - number to append.
+ */
+void append_real(std::string& s, real x);
+
+/**
+ * @brief Append length to string.
+ * The value is written same way as by append_real(), followed by the unit.
+ * @param s - string to append the length to.
+ * @param l - length to append.
+ */
+void append_length(std::string& s, const length& l);
+
 void skip_whitespaces(std::istream& s);
 
 void skip_whitespaces_and_comma(std::istream& s);
@@ -20,17 +133,15 @@ std::string read_till_char(std::istream& s, char c);
 
 std::string read_till_char_or_whitespace(std::istream& s, char c);
 
-real read_in_real(std::istream& s);
-
-std::string trim_tail(const std::string& s);
+std::string_view trim_tail(std::string_view s);
 
 std::string iri_to_local_id(const std::string& iri);
 
-coordinate_units parse_coordinate_units(const std::string& s);
+coordinate_units parse_coordinate_units(std::string_view s);
 
 std::string coordinate_units_to_string(coordinate_units u);
 
-r4::vector2<real> parse_number_and_optional_number(const std::string& s, r4::vector2<real> defaults);
+r4::vector2<real> parse_number_and_optional_number(std::string_view s, r4::vector2<real> defaults);
 
 std::string number_and_optional_number_to_string(std::array<real, 2> non, real optionalNumberDefault);
 
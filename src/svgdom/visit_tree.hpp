@@ -0,0 +1,161 @@
+#pragma once
+
+#include <type_traits>
+
+#include "visitor.hpp"
+
+namespace svgdom{
+
+/**
+ * @brief Helper for combining several lambdas into one function object.
+ * Example:
+ * @code
+ * svgdom::overloaded{
+ *     [](const svgdom::path_element& e){...},
+ *     [](const svgdom::element& e){...} // all other elements
+ * }
+ * @endcode
+ */
+template <class... T> struct overloaded : T...{
+	using T::operator()...;
+};
+
+template <class... T> overloaded(T...) -> overloaded<T...>;
+
+/**
+ * @brief Call handler for element of its actual class.
+ * The element class is selected by switching on element type tag, see element::get_type(),
+ * so unlike visitor, no virtual calls are made and the handler can be inlined.
+ * Elements of unknown type, i.e. custom elements, are passed to the handler as svgdom::element.
+ * @param e - element to pass to the handler, can be const or non-const.
+ * @param handler - function object callable with reference to any element class known to visitor,
+ *                  and with reference to svgdom::element. Element references are const if 'e' is const.
+ */
+template <class T_element, class T_handler> void visit_element(T_element& elem, T_handler&& handler){
+	static_assert(std::is_base_of<element, std::remove_const_t<T_element>>::value, "T_element must be svgdom::element");
+
+	std::conditional_t<std::is_const<T_element>::value, const element, element>& e = elem;
+
+	auto call = [&e, &handler](auto* tag){
+		typedef std::remove_pointer_t<decltype(tag)> element_class;
+		typedef std::conditional_t<std::is_const<T_element>::value, const element_class, element_class> type;
+		handler(static_cast<type&>(e));
+	};
+
+	switch(e.get_type()){
+		case element_type::path:
+			call((path_element*)nullptr);
+			break;
+		case element_type::rect:
+			call((rect_element*)nullptr);
+			break;
+		case element_type::circle:
+			call((circle_element*)nullptr);
+			break;
+		case element_type::ellipse:
+			call((ellipse_element*)nullptr);
+			break;
+		case element_type::line:
+			call((line_element*)nullptr);
+			break;
+		case element_type::polyline:
+			call((polyline_element*)nullptr);
+			break;
+		case element_type::polygon:
+			call((polygon_element*)nullptr);
+			break;
+		case element_type::g:
+			call((g_element*)nullptr);
+			break;
+		case element_type::svg:
+			call((svg_element*)nullptr);
+			break;
+		case element_type::symbol:
+			call((symbol_element*)nullptr);
+			break;
+		case element_type::use:
+			call((use_element*)nullptr);
+			break;
+		case element_type::defs:
+			call((defs_element*)nullptr);
+			break;
+		case element_type::stop:
+			call((gradient::stop_element*)nullptr);
+			break;
+		case element_type::linear_gradient:
+			call((linear_gradient_element*)nullptr);
+			break;
+		case element_type::radial_gradient:
+			call((radial_gradient_element*)nullptr);
+			break;
+		case element_type::filter:
+			call((filter_element*)nullptr);
+			break;
+		case element_type::fe_gaussian_blur:
+			call((fe_gaussian_blur_element*)nullptr);
+			break;
+		case element_type::fe_color_matrix:
+			call((fe_color_matrix_element*)nullptr);
+			break;
+		case element_type::fe_blend:
+			call((fe_blend_element*)nullptr);
+			break;
+		case element_type::fe_composite:
+			call((fe_composite_element*)nullptr);
+			break;
+		case element_type::image:
+			call((image_element*)nullptr);
+			break;
+		case element_type::mask:
+			call((mask_element*)nullptr);
+			break;
+		case element_type::text:
+			call((text_element*)nullptr);
+			break;
+		case element_type::style:
+			call((style_element*)nullptr);
+			break;
+		default:
+			handler(e);
+			break;
+	}
+}
+
+/**
+ * @brief Traverse element tree.
+ * Calls handler for each element of the tree in document order (pre-order),
+ * see visit_element() for details about how the handler is called.
+ * This is a faster alternative to visitor for the operations which do not need to do anything
+ * after the children of an element are visited.
+ * Children of custom container elements are also traversed.
+ * @param root - root element of the tree to traverse, can be const or non-const.
+ * @param handler - function object to call for each element.
+ */
+template <class T_element, class T_handler> void visit_tree(T_element& root, T_handler&& handler){
+	typedef std::conditional_t<std::is_const<T_element>::value, const container, container> container_type;
+	typedef std::conditional_t<std::is_const<T_element>::value, const element, element> child_type;
+
+	container_type* children = nullptr;
+
+	visit_element(root, [&handler, &children](auto& e){
+		handler(e);
+
+		typedef std::remove_const_t<std::remove_reference_t<decltype(e)>> type;
+
+		if constexpr (std::is_base_of<container, type>::value){
+			children = &e;
+		}else if constexpr (std::is_same<element, type>::value){
+			children = dynamic_cast<container_type*>(&e);
+		}
+	});
+
+	if(!children){
+		return;
+	}
+
+	for(auto& c : children->children){
+		visit_tree(static_cast<child_type&>(*c), handler);
+	}
+}
+
+}
@@ -0,0 +1,93 @@
+#include "../../src/svgdom/dom.hpp"
+
+#include <utki/debug.hpp>
+
+namespace{
+const std::string svg_str = R"qwertyuiop(
+<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink" width="100" height="100">
+	<defs>
+		<linearGradient id="grad">
+			<stop offset="0" stop-color="#ff0000"/>
+			<stop offset="1" stop-color="blue"/>
+		</linearGradient>
+		<rect id="r" width="10" height="10"/>
+	</defs>
+	<g transform="translate(10, 20)">
+		<path d="M 0 0 L 10 10 z" fill="url(#grad)" stroke="black"/>
+		<use xlink:href="#r" x="50"/>
+		<circle cx="50" cy="50" r="20" style="fill:green"/>
+	</g>
+</svg>
+)qwertyuiop";
+
+class counting_resource : public std::pmr::memory_resource{
+	std::pmr::monotonic_buffer_resource arena;
+public:
+	size_t num_allocations = 0;
+	size_t num_deallocations = 0;
+
+	void* do_allocate(size_t bytes, size_t alignment)override{
+		++this->num_allocations;
+		return this->arena.allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* p, size_t bytes, size_t alignment)override{
+		++this->num_deallocations;
+		this->arena.deallocate(p, bytes, alignment);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other)const noexcept override{
+		return this == &other;
+	}
+};
+}
+
+int main(int argc, char** argv){
+	auto heap_dom = svgdom::load(svg_str);
+	ASSERT_ALWAYS(heap_dom)
+
+	counting_resource arena;
+	{
+		auto arena_dom = svgdom::load(utki::make_span(svg_str), arena);
+		ASSERT_ALWAYS(arena_dom)
+
+		// svg, defs, linearGradient, 2 stops, rect, g, path, use, circle
+		ASSERT_INFO_ALWAYS(arena.num_allocations == 10, "arena.num_allocations = " << arena.num_allocations)
+
+		ASSERT_ALWAYS(arena_dom->to_string() == heap_dom->to_string())
+
+		// elements added after loading are allocated from the heap
+		arena_dom->children.push_back(std::make_unique<svgdom::g_element>());
+		ASSERT_ALWAYS(arena.num_allocations == 10)
+	}
+	// memory of deleted elements is not returned to the memory resource one by one
+	ASSERT_INFO_ALWAYS(arena.num_deallocations == 0, "arena.num_deallocations = " << arena.num_deallocations)
+
+	// elements loaded without arena after the arena load are allocated from the heap
+	auto dom = svgdom::load(svg_str);
+	ASSERT_ALWAYS(arena.num_allocations == 10)
+	ASSERT_ALWAYS(dom->to_string() == heap_dom->to_string())
+
+	// arena elements can be removed from the tree and deleted one by one
+	{
+		auto arena_dom = svgdom::load(utki::make_span(svg_str), arena);
+		auto& g = dynamic_cast<svgdom::g_element&>(*arena_dom->children.back());
+		ASSERT_ALWAYS(g.get_type() == svgdom::element_type::g)
+		ASSERT_ALWAYS(g.children.size() == 3)
+		auto path = std::move(g.children.front());
+		g.children.pop_front();
+		ASSERT_ALWAYS(dynamic_cast<svgdom::path_element*>(path.get()))
+		path.reset();
+		arena_dom->children.clear();
+	}
+	ASSERT_ALWAYS(arena.num_deallocations == 0)
+
+	// copies of arena elements are allocated from the heap and deleted as usual
+	{
+		auto arena_dom = svgdom::load(utki::make_span(svg_str), arena);
+		auto copy = std::make_unique<svgdom::svg_element>(*arena_dom);
+		arena_dom.reset();
+		ASSERT_ALWAYS(copy->id == dom->id)
+	}
+	ASSERT_ALWAYS(arena.num_deallocations == 0)
+}
@@ -4,6 +4,12 @@
 
 #include <utki/debug.hpp>
 
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <utility>
+
 int main(int argc, char** argv){
 	std::unique_ptr<svgdom::svg_element> domOriginal = std::make_unique<svgdom::svg_element>();
 	
@@ -44,4 +50,135 @@ int main(int argc, char** argv){
 	std::string domCloneStr = domClone->to_string();
 	
 	ASSERT_ALWAYS(domOriginalStr == domCloneStr)
+
+	// copy-on-write clone shares data with the original until modified
+	{
+		auto& original_path = dynamic_cast<svgdom::path_element&>(*domOriginal->children.front());
+		original_path.styles.set(svgdom::style_property::fill, svgdom::make_style_value(0x42, 0x13, 0xfe));
+		domOriginalStr = domOriginal->to_string();
+
+		svgdom::cloner cow_cloner(true);
+		domOriginal->accept(cow_cloner);
+		auto cow_clone = cow_cloner.get_clone_as<svgdom::svg_element>();
+		ASSERT_ALWAYS(cow_clone)
+		ASSERT_ALWAYS(cow_clone->to_string() == domOriginalStr)
+
+		const auto& clone_path = dynamic_cast<const svgdom::path_element&>(*cow_clone->children.front());
+		ASSERT_ALWAYS(clone_path.path.coordinates().data() == original_path.path.coordinates().data())
+		ASSERT_ALWAYS(&*clone_path.styles.begin() == &*static_cast<const svgdom::style_map&>(original_path.styles).begin())
+
+		// modifying the clone does not change the original
+		auto& mutable_clone_path = dynamic_cast<svgdom::path_element&>(*cow_clone->children.front());
+		mutable_clone_path.path.push_back(step);
+		mutable_clone_path.styles[svgdom::style_property::stroke] = svgdom::make_style_value(0, 0, 0);
+		ASSERT_ALWAYS(clone_path.path.coordinates().data() != original_path.path.coordinates().data())
+		ASSERT_ALWAYS(clone_path.path.size() == original_path.path.size() + 1)
+		ASSERT_ALWAYS(clone_path.styles.size() == 2)
+		ASSERT_ALWAYS(domOriginal->to_string() == domOriginalStr)
+
+		// modifying the original does not change other clones
+		svgdom::cloner cow_cloner2(true);
+		domOriginal->accept(cow_cloner2);
+		auto cow_clone2 = cow_cloner2.get_clone_as<svgdom::svg_element>();
+		ASSERT_ALWAYS(cow_clone2)
+		original_path.path.clear();
+		original_path.styles.erase(svgdom::style_property::fill);
+		ASSERT_ALWAYS(cow_clone2->to_string() == domOriginalStr)
+
+		// plain copies also share path data
+		svgdom::path_element copy(mutable_clone_path);
+		ASSERT_ALWAYS(copy.path.coordinates().data() == clone_path.path.coordinates().data())
+		ASSERT_ALWAYS(copy.path == clone_path.path)
+
+		// style map which gave out non-const references to its values is not shared with copies
+		ASSERT_ALWAYS(&*std::as_const(copy.styles).begin() != &*clone_path.styles.begin())
+		ASSERT_ALWAYS(copy.styles.size() == clone_path.styles.size())
+
+		// clone made not in copy-on-write mode does not share data
+		svgdom::cloner deep_cloner;
+		mutable_clone_path.accept(deep_cloner);
+		auto deep_clone = deep_cloner.get_clone_as<svgdom::path_element>();
+		ASSERT_ALWAYS(deep_clone)
+		ASSERT_ALWAYS(deep_clone->path.coordinates().data() != clone_path.path.coordinates().data())
+		ASSERT_ALWAYS(deep_clone->path == clone_path.path)
+	}
+
+	// all element types are cloned, including the ones inside of masks and text
+	{
+		auto dom = svgdom::load(std::string(
+				R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg"><defs><mask id="m"><rect width="10" height="10"/><g><circle r="3"/></g></mask><filter id="f"><feColorMatrix type="saturate" values="0.5"/><feBlend mode="multiply"/><feComposite operator="in"/></filter></defs><text x="1">hello</text><g mask="url(#m)"><path d="M0,0 L1,1"/></g></svg>)qwertyuiop"
+			));
+		ASSERT_ALWAYS(dom)
+
+		svgdom::cloner c;
+		dom->accept(c);
+		auto clone = c.get_clone_as<svgdom::svg_element>();
+		ASSERT_ALWAYS(clone)
+		ASSERT_INFO_ALWAYS(clone->to_string() == dom->to_string(), "clone = " << clone->to_string() << ", original = " << dom->to_string())
+
+		// cloning a subtree
+		svgdom::cloner sc;
+		dom->children.front()->accept(sc);
+		auto defs = sc.get_clone_as<svgdom::defs_element>();
+		ASSERT_ALWAYS(defs)
+		ASSERT_ALWAYS(defs->to_string() == dom->children.front()->to_string())
+	}
+
+	// cloner subclass is called for descendants of the cloned element
+	{
+		class path_skipping_cloner : public svgdom::cloner{
+		public:
+			unsigned num_paths = 0;
+
+			void visit(const svgdom::path_element& e)override{
+				++this->num_paths;
+			}
+		} c;
+
+		domOriginal->accept(c);
+		ASSERT_ALWAYS(c.num_paths == 1)
+		auto clone = c.get_clone_as<svgdom::svg_element>();
+		ASSERT_ALWAYS(clone)
+		ASSERT_ALWAYS(clone->children.empty())
+	}
+
+	// copy-on-write clones of the same document from several threads simultaneously
+	for(unsigned i = 0; i != 100; ++i){
+		const svgdom::svg_element& original = *domOriginal;
+
+		const unsigned num_threads = 4;
+
+		std::atomic<unsigned> num_ready{0};
+		std::vector<std::string> results(num_threads);
+		std::vector<std::thread> threads;
+
+		for(unsigned t = 0; t != num_threads; ++t){
+			threads.emplace_back([&num_ready, &original, &str = results[t]](){
+				++num_ready;
+				while(num_ready != num_threads){
+					std::this_thread::yield();
+				}
+				svgdom::cloner c(true);
+				original.accept(c);
+				auto clone = c.get_clone_as<svgdom::svg_element>();
+				ASSERT_ALWAYS(clone)
+
+				// modify the clone, the original and other clones are not affected
+				auto& p = dynamic_cast<svgdom::path_element&>(*clone->children.front());
+				p.styles[svgdom::style_property::stroke_width] = svgdom::real(3);
+				p.path.clear();
+
+				str = clone->to_string();
+			});
+		}
+
+		for(auto& t : threads){
+			t.join();
+		}
+
+		for(auto& r : results){
+			ASSERT_INFO_ALWAYS(r == results.front(), "r = " << r << ", results.front() = " << results.front())
+		}
+		ASSERT_ALWAYS(domOriginal->to_string() != results.front())
+	}
 }
@@ -43,6 +43,9 @@ public:
 	using svgdom::stream_writer::visit;
 
 	void visit(const CustomElement& e)override{
+		// write arbitrary content directly to the stream
+		this->s << this->indent_str() << "<!-- custom element -->" << std::endl;
+
 		this->set_name("custom");
 		this->add_attribute("customAttrib1", "value1");
 		this->add_attribute("customAttrib2", "value2");
@@ -92,4 +95,9 @@ int main(int argc, char** argv){
 	
 	ASSERT_ALWAYS(str.find("xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" version=\"1.1\"") != std::string::npos)
 	ASSERT_ALWAYS(str.find("<custom customAttrib1=\"value1\" customAttrib2=\"value2\"/>") != std::string::npos)
+
+	// content written directly to the stream goes in the right place
+	ASSERT_ALWAYS(str.find("<!-- custom element -->\n\t<custom ") != std::string::npos)
+	ASSERT_ALWAYS(str.find("<path ") < str.find("<!-- custom element -->"))
+	ASSERT_ALWAYS(str.find("<!-- custom element -->") < str.find("</svg>"))
 }
@@ -9,6 +9,78 @@
 #include <papki/fs_file.hpp>
 
 int main(int argc, char** argv){
+	// test style stack reconstruction
+	{
+		auto dom = svgdom::load(std::string(
+				R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg"><g id="g1" fill="red"><rect id="r1" stroke="blue"/></g><g id="g2"><circle id="c1"/></g></svg>)qwertyuiop"
+			));
+		ASSERT_ALWAYS(dom)
+
+		svgdom::finder f(*dom);
+		ASSERT_ALWAYS(f.size() == 4)
+		ASSERT_ALWAYS(!f.find_by_id("unknown"))
+
+		auto r1 = f.find_by_id("r1");
+		ASSERT_ALWAYS(r1)
+		auto ss = f.get_style_stack(*r1);
+		ASSERT_ALWAYS(ss.stack.size() == 3)
+		ASSERT_ALWAYS(&ss.stack.back().get() == dynamic_cast<const svgdom::styleable*>(&r1->e))
+		ASSERT_ALWAYS(ss.get_style_property(svgdom::style_property::fill))
+		ASSERT_ALWAYS(ss.get_style_property(svgdom::style_property::stroke))
+
+		auto c1 = f.find_by_id("c1");
+		ASSERT_ALWAYS(c1)
+		auto ss2 = f.get_style_stack(*c1);
+		ASSERT_ALWAYS(ss2.stack.size() == 3)
+		ASSERT_ALWAYS(!ss2.get_style_property(svgdom::style_property::fill))
+
+		// elements inside of masks are found
+		{
+			auto d = svgdom::load(std::string(
+					R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg"><mask id="m" fill="red"><rect id="mr"/></mask></svg>)qwertyuiop"
+				));
+			ASSERT_ALWAYS(d)
+			svgdom::finder mf(*d);
+			ASSERT_ALWAYS(mf.size() == 2)
+			auto mr = mf.find_by_id("mr");
+			ASSERT_ALWAYS(mr)
+			auto mss = mf.get_style_stack(*mr);
+			ASSERT_ALWAYS(mss.stack.size() == 3)
+			ASSERT_ALWAYS(mss.get_style_property(svgdom::style_property::fill))
+		}
+
+		// copied and moved finders do not refer to the ancestry table of the original finder
+		std::unique_ptr<svgdom::finder> copy;
+		{
+			svgdom::finder f2(f);
+			copy = std::make_unique<svgdom::finder>(f2);
+		}
+		svgdom::finder moved(std::move(f));
+		for(auto finder : {copy.get(), &moved}){
+			auto r = finder->find_by_id(std::string("r1"));
+			ASSERT_ALWAYS(r)
+			ASSERT_ALWAYS(&r->e == &r1->e)
+			auto s = finder->get_style_stack(*r);
+			ASSERT_ALWAYS(s.stack.size() == 3)
+			ASSERT_ALWAYS(s.get_style_property(svgdom::style_property::fill))
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+			auto old_ss = r->ss();
+#pragma GCC diagnostic pop
+			ASSERT_ALWAYS(old_ss.stack.size() == 3)
+			ASSERT_ALWAYS(&old_ss.stack.back().get() == &s.stack.back().get())
+		}
+
+		// changing ids of the elements invalidates the finder
+		{
+			svgdom::finder vf(*dom);
+			ASSERT_ALWAYS(vf.is_valid())
+			dom->children.back()->id = "group2";
+			ASSERT_ALWAYS(!vf.is_valid())
+		}
+	}
+
 	auto loadStart = utki::get_ticks_ms();
 	
 	auto dom = svgdom::load(papki::fs_file("../samples/testdata/back.svg"));
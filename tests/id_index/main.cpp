@@ -0,0 +1,120 @@
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/id_index.hpp"
+
+#include <algorithm>
+
+#include <utki/debug.hpp>
+
+int main(int argc, char** argv){
+	auto dom = svgdom::load(std::string(
+			R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg" id="root">
+				<g id="g1"><rect id="r1"/><circle id="dup"/></g>
+				<defs><linearGradient id="lg"><stop/></linearGradient></defs>
+				<mask id="m1"><ellipse id="e1"/></mask>
+			</svg>)qwertyuiop"
+		));
+	ASSERT_ALWAYS(dom)
+
+	svgdom::id_index index(*dom);
+
+	// all elements, including descendants of every container type, are indexed
+	ASSERT_INFO_ALWAYS(index.size() == 7, "index.size() = " << index.size())
+	ASSERT_ALWAYS(index.find_by_id("root") == dom.get())
+	ASSERT_ALWAYS(dynamic_cast<svgdom::linear_gradient_element*>(index.find_by_id("lg")))
+	ASSERT_ALWAYS(dynamic_cast<svgdom::ellipse_element*>(index.find_by_id("e1")))
+	ASSERT_ALWAYS(!index.find_by_id("unknown"))
+	ASSERT_ALWAYS(!index.find_by_id(""))
+
+	auto g1 = dynamic_cast<svgdom::g_element*>(index.find_by_id("g1"));
+	ASSERT_ALWAYS(g1)
+	auto dup = index.find_by_id("dup");
+	ASSERT_ALWAYS(dynamic_cast<svgdom::circle_element*>(dup))
+
+	// insert subtree
+	{
+		auto g = std::make_unique<svgdom::g_element>();
+		g->id = "g2";
+		auto p = std::make_unique<svgdom::path_element>();
+		p->id = "p1";
+		g->children.push_back(std::move(p));
+		auto l = std::make_unique<svgdom::line_element>();
+		l->id = "dup";
+		g->children.push_back(std::move(l));
+
+		auto i = index.insert(*dom, dom->children.begin(), std::move(g));
+		ASSERT_ALWAYS(i == dom->children.begin())
+		ASSERT_ALWAYS(index.size() == 9)
+		ASSERT_ALWAYS(index.find_by_id("g2") == i->get())
+		ASSERT_ALWAYS(dynamic_cast<svgdom::path_element*>(index.find_by_id("p1")))
+
+		// element indexed first keeps the id
+		ASSERT_ALWAYS(index.find_by_id("dup") == dup)
+	}
+
+	// change id
+	{
+		auto r1 = index.find_by_id("r1");
+		ASSERT_ALWAYS(r1)
+		index.set_id(*r1, "r2");
+		ASSERT_ALWAYS(r1->id == "r2")
+		ASSERT_ALWAYS(!index.find_by_id("r1"))
+		ASSERT_ALWAYS(index.find_by_id("r2") == r1)
+		ASSERT_ALWAYS(index.size() == 9)
+
+		index.set_id(*r1, "");
+		ASSERT_ALWAYS(!index.find_by_id("r2"))
+		ASSERT_ALWAYS(index.size() == 8)
+
+		index.set_id(*r1, "r1");
+		ASSERT_ALWAYS(index.find_by_id("r1") == r1)
+		ASSERT_ALWAYS(index.size() == 9)
+	}
+
+	// remove subtree, duplicate id is taken over by remaining element
+	{
+		auto i = std::find_if(
+				dom->children.begin(),
+				dom->children.end(),
+				[g1](const auto& c){return c.get() == g1;}
+			);
+		ASSERT_ALWAYS(i != dom->children.end())
+
+		auto removed = index.remove(*dom, i);
+		ASSERT_ALWAYS(removed.get() == g1)
+		ASSERT_ALWAYS(!index.find_by_id("g1"))
+		ASSERT_ALWAYS(!index.find_by_id("r1"))
+		ASSERT_ALWAYS(index.size() == 7)
+
+		auto d = index.find_by_id("dup");
+		ASSERT_ALWAYS(d)
+		ASSERT_ALWAYS(d != dup)
+		ASSERT_ALWAYS(dynamic_cast<svgdom::line_element*>(d))
+
+		// removed element can be inserted back
+		index.insert(*dom, dom->children.end(), std::move(removed));
+		ASSERT_ALWAYS(index.find_by_id("r1"))
+		ASSERT_ALWAYS(index.find_by_id("dup") == d)
+		ASSERT_ALWAYS(index.size() == 9)
+	}
+
+	// remove duplicate which does not own the id
+	{
+		auto i = std::find_if(
+				dom->children.begin(),
+				dom->children.end(),
+				[g1](const auto& c){return c.get() == g1;}
+			);
+		ASSERT_ALWAYS(i != dom->children.end())
+		auto d = index.find_by_id("dup");
+		index.remove(*dom, i);
+		ASSERT_ALWAYS(index.find_by_id("dup") == d)
+
+		// remove subtree of the last 'dup'
+		auto g2 = index.find_by_id("g2");
+		ASSERT_ALWAYS(g2 == dom->children.front().get())
+		index.remove(*dom, dom->children.begin());
+		ASSERT_ALWAYS(!index.find_by_id("dup"))
+		ASSERT_ALWAYS(!index.find_by_id("p1"))
+		ASSERT_INFO_ALWAYS(index.size() == 4, "index.size() = " << index.size())
+	}
+}
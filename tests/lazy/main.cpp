@@ -0,0 +1,130 @@
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/visitor.hpp"
+#include "../../src/svgdom/cloner.hpp"
+
+#include <thread>
+#include <atomic>
+
+#include <utki/debug.hpp>
+
+namespace{
+const std::string svg_str = R"qwertyuiop(
+<svg xmlns="http://www.w3.org/2000/svg" width="100" height="100">
+	<defs>
+		<linearGradient id="grad" gradientTransform="rotate(45)">
+			<stop offset="0" stop-color="#ff0000"/>
+			<stop offset="1" style="stop-color: blue"/>
+		</linearGradient>
+	</defs>
+	<g id="g" transform="translate(10, 20) scale(2)" style="fill: red; stroke: green">
+		<path id="p1" d="M 0 0 L 10 10 C 1 2 3 4 5 6 A 1 2 3 1 0 7 8 z" fill="url(#grad)" stroke="black"/>
+		<path id="p2" d="M 1 1 h 10 v 10 z" transform="skewX(30)" style="opacity: 0.5"/>
+	</g>
+</svg>
+)qwertyuiop";
+
+// collects string representations of all path data, transformations and styles
+class collector : public svgdom::const_visitor{
+public:
+	std::string str;
+
+	void visit(const svgdom::path_element& e)override{
+		this->str += e.path_to_string() + ";" + e.transformations_to_string() + ";" + e.styles_to_string() + ";";
+	}
+
+	void visit(const svgdom::g_element& e)override{
+		this->str += e.transformations_to_string() + ";" + e.styles_to_string() + ";";
+		this->relay_accept(e);
+	}
+
+	void visit(const svgdom::linear_gradient_element& e)override{
+		this->str += e.transformations_to_string() + ";";
+		this->relay_accept(e);
+	}
+
+	void visit(const svgdom::gradient::stop_element& e)override{
+		this->str += e.styles_to_string() + ";";
+	}
+
+	void default_visit(const svgdom::element& e, const svgdom::container& c)override{
+		this->relay_accept(c);
+	}
+};
+}
+
+int main(int argc, char** argv){
+	auto eager_dom = svgdom::load(svg_str);
+	ASSERT_ALWAYS(eager_dom)
+
+	collector eager;
+	eager_dom->accept(eager);
+
+	// lazily loaded document is the same as eagerly loaded one
+	{
+		auto dom = svgdom::load_lazy(utki::make_span(svg_str));
+		ASSERT_ALWAYS(dom)
+		ASSERT_ALWAYS(dom->to_string() == eager_dom->to_string())
+	}
+
+	// clone of not yet parsed document
+	{
+		auto dom = svgdom::load_lazy(utki::make_span(svg_str));
+		ASSERT_ALWAYS(dom)
+		svgdom::cloner cloner;
+		dom->accept(cloner);
+		auto clone = cloner.get_clone_as<svgdom::svg_element>();
+		ASSERT_ALWAYS(clone)
+		dom.reset();
+		ASSERT_ALWAYS(clone->to_string() == eager_dom->to_string())
+	}
+
+	// modifying not yet parsed values
+	{
+		auto dom = svgdom::load_lazy(utki::make_span(svg_str));
+		ASSERT_ALWAYS(dom)
+		auto g = dynamic_cast<svgdom::g_element*>(std::next(dom->children.begin())->get());
+		ASSERT_ALWAYS(g)
+		g->styles[svgdom::style_property::opacity] = svgdom::real(0.5);
+		ASSERT_INFO_ALWAYS(g->styles.size() == 3, "g->styles.size() = " << g->styles.size())
+
+		auto p = dynamic_cast<svgdom::path_element*>(g->children.front().get());
+		ASSERT_ALWAYS(p)
+		svgdom::path_element::step s{};
+		s.type_ = svgdom::path_element::step::type::close;
+		p->path.push_back(s);
+		ASSERT_INFO_ALWAYS(p->path.size() == 6, "p->path.size() = " << p->path.size())
+
+		g->transformations.clear();
+		ASSERT_ALWAYS(g->transformations.empty())
+	}
+
+	// first access from several threads simultaneously
+	for(unsigned i = 0; i != 100; ++i){
+		auto dom = svgdom::load_lazy(utki::make_span(svg_str));
+		ASSERT_ALWAYS(dom)
+
+		const unsigned num_threads = 4;
+
+		std::atomic<unsigned> num_ready{0};
+		std::vector<collector> collectors(num_threads);
+		std::vector<std::thread> threads;
+
+		for(unsigned t = 0; t != num_threads; ++t){
+			threads.emplace_back([&num_ready, &dom, &c = collectors[t]](){
+				++num_ready;
+				while(num_ready != num_threads){
+					std::this_thread::yield();
+				}
+				dom->accept(c);
+			});
+		}
+
+		for(auto& t : threads){
+			t.join();
+		}
+
+		for(auto& c : collectors){
+			ASSERT_INFO_ALWAYS(c.str == eager.str, "c.str = " << c.str << ", eager.str = " << eager.str)
+		}
+	}
+}
@@ -0,0 +1,76 @@
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/node_table.hpp"
+
+#include <iterator>
+
+#include <utki/debug.hpp>
+
+int main(int argc, char** argv){
+	auto dom = svgdom::load(std::string(
+			R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg">
+				<g id="g1">
+					<rect id="r1"/>
+					<g id="g2"><circle id="c1"/><path id="p1" d="M 0 0 L 1 1"/></g>
+					<line id="l1"/>
+				</g>
+				<defs><linearGradient id="lg"><stop/></linearGradient></defs>
+				<mask id="m1"/>
+			</svg>)qwertyuiop"
+		));
+	ASSERT_ALWAYS(dom)
+
+	svgdom::node_table t(*dom);
+
+	typedef svgdom::element_type et;
+	const auto npos = svgdom::node_table::npos;
+
+	// nodes are in pre-order
+	struct expected{
+		const char* id;
+		et type;
+		uint32_t parent;
+		uint32_t first_child;
+		uint32_t next_sibling;
+		uint32_t depth;
+		uint32_t subtree_size;
+	};
+	const expected exp[] = {
+		{"", et::svg, npos, 1, npos, 0, 11},
+		{"g1", et::g, 0, 2, 7, 1, 6},
+		{"r1", et::rect, 1, npos, 3, 2, 1},
+		{"g2", et::g, 1, 4, 6, 2, 3},
+		{"c1", et::circle, 3, npos, 5, 3, 1},
+		{"p1", et::path, 3, npos, npos, 3, 1},
+		{"l1", et::line, 1, npos, npos, 2, 1},
+		{"", et::defs, 0, 8, 10, 1, 3},
+		{"lg", et::linear_gradient, 7, 9, npos, 2, 2},
+		{"", et::stop, 8, npos, npos, 3, 1},
+		{"m1", et::mask, 0, npos, npos, 1, 1},
+	};
+
+	ASSERT_INFO_ALWAYS(t.size() == std::size(exp), "t.size() = " << t.size())
+	ASSERT_ALWAYS(t[0].e == dom.get())
+
+	for(uint32_t i = 0; i != t.size(); ++i){
+		const auto& n = t[i];
+		const auto& x = exp[i];
+		ASSERT_INFO_ALWAYS(n.e->id == x.id, "i = " << i << ", id = " << n.e->id)
+		ASSERT_INFO_ALWAYS(n.type == x.type, "i = " << i)
+		ASSERT_INFO_ALWAYS(n.parent == x.parent, "i = " << i << ", parent = " << n.parent)
+		ASSERT_INFO_ALWAYS(n.first_child == x.first_child, "i = " << i << ", first_child = " << n.first_child)
+		ASSERT_INFO_ALWAYS(n.next_sibling == x.next_sibling, "i = " << i << ", next_sibling = " << n.next_sibling)
+		ASSERT_INFO_ALWAYS(n.depth == x.depth, "i = " << i << ", depth = " << n.depth)
+		ASSERT_INFO_ALWAYS(n.subtree_size == x.subtree_size, "i = " << i << ", subtree_size = " << n.subtree_size)
+	}
+
+	ASSERT_ALWAYS(t.subtree_end(3) == 6)
+	ASSERT_ALWAYS(t.subtree_end(0) == t.size())
+
+	ASSERT_ALWAYS(t.is_ancestor(0, 5))
+	ASSERT_ALWAYS(t.is_ancestor(1, 5))
+	ASSERT_ALWAYS(t.is_ancestor(3, 5))
+	ASSERT_ALWAYS(!t.is_ancestor(5, 5))
+	ASSERT_ALWAYS(!t.is_ancestor(2, 5))
+	ASSERT_ALWAYS(!t.is_ancestor(5, 3))
+	ASSERT_ALWAYS(!t.is_ancestor(1, 7))
+}
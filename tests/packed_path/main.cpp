@@ -0,0 +1,270 @@
+#include "../../src/svgdom/elements/shapes.hpp"
+
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+#include <utki/debug.hpp>
+
+int main(int argc, char** argv){
+	auto path = svgdom::path_element::parse("M 1 2 h 3 V 4 C 5 6 7 8 9 10 s 11 12 13 14 Q 15 16 17 18 t 19 20 A 21 22 23 1 0 24 25 a 26 27 28 0 1 29 30 z");
+
+	ASSERT_INFO_ALWAYS(path.size() == 10, "path.size() = " << path.size())
+	ASSERT_INFO_ALWAYS(path.coordinates().size() == 30, "path.coordinates().size() = " << path.coordinates().size())
+
+	// coordinates are stored in the order of appearance
+	for(size_t i = 0; i != path.coordinates().size(); ++i){
+		ASSERT_ALWAYS(path.coordinates()[i] == svgdom::real(i + 1))
+	}
+
+	auto steps = path.to_steps();
+	ASSERT_ALWAYS(steps.size() == 10)
+
+	typedef svgdom::path_element::step::type step_type;
+
+	ASSERT_ALWAYS(steps[0].type_ == step_type::move_abs)
+	ASSERT_ALWAYS(steps[0].x == 1 && steps[0].y == 2)
+
+	ASSERT_ALWAYS(steps[1].type_ == step_type::horizontal_line_rel)
+	ASSERT_ALWAYS(steps[1].x == 3 && steps[1].y == 0)
+
+	ASSERT_ALWAYS(steps[2].type_ == step_type::vertical_line_abs)
+	ASSERT_ALWAYS(steps[2].x == 0 && steps[2].y == 4)
+
+	ASSERT_ALWAYS(steps[3].type_ == step_type::cubic_abs)
+	ASSERT_ALWAYS(steps[3].x1 == 5 && steps[3].y1 == 6 && steps[3].x2 == 7 && steps[3].y2 == 8 && steps[3].x == 9 && steps[3].y == 10)
+
+	ASSERT_ALWAYS(steps[4].type_ == step_type::cubic_smooth_rel)
+	ASSERT_ALWAYS(steps[4].x2 == 11 && steps[4].y2 == 12 && steps[4].x == 13 && steps[4].y == 14)
+
+	ASSERT_ALWAYS(steps[5].type_ == step_type::quadratic_abs)
+	ASSERT_ALWAYS(steps[5].x1 == 15 && steps[5].y1 == 16 && steps[5].x == 17 && steps[5].y == 18)
+
+	ASSERT_ALWAYS(steps[6].type_ == step_type::quadratic_smooth_rel)
+	ASSERT_ALWAYS(steps[6].x == 19 && steps[6].y == 20)
+
+	ASSERT_ALWAYS(steps[7].type_ == step_type::arc_abs)
+	ASSERT_ALWAYS(steps[7].rx == 21 && steps[7].ry == 22 && steps[7].x_axis_rotation == 23 && steps[7].x == 24 && steps[7].y == 25)
+	ASSERT_ALWAYS(steps[7].flags.large_arc && !steps[7].flags.sweep)
+
+	ASSERT_ALWAYS(steps[8].type_ == step_type::arc_rel)
+	ASSERT_ALWAYS(steps[8].rx == 26 && steps[8].ry == 27 && steps[8].x_axis_rotation == 28 && steps[8].x == 29 && steps[8].y == 30)
+	ASSERT_ALWAYS(!steps[8].flags.large_arc && steps[8].flags.sweep)
+
+	ASSERT_ALWAYS(steps[9].type_ == step_type::close)
+
+	// packing unpacked steps gives the same packed path
+	ASSERT_ALWAYS(svgdom::path_element::packed_path(steps) == path)
+
+	// iteration yields the same steps as to_steps()
+	{
+		size_t i = 0;
+		for(auto s : path){
+			ASSERT_ALWAYS(i < steps.size())
+			ASSERT_ALWAYS(s.type_ == steps[i].type_)
+			ASSERT_ALWAYS(s.x == steps[i].x && s.y == steps[i].y)
+			++i;
+		}
+		ASSERT_ALWAYS(i == steps.size())
+	}
+
+	// indexed access yields the same steps as to_steps()
+	for(size_t i = 0; i != steps.size(); ++i){
+		auto s = path[i];
+		ASSERT_ALWAYS(s.type_ == steps[i].type_)
+		ASSERT_ALWAYS(s.x == steps[i].x && s.y == steps[i].y && s.x1 == steps[i].x1 && s.rx == steps[i].rx)
+		ASSERT_ALWAYS(s.flags.large_arc == steps[i].flags.large_arc && s.flags.sweep == steps[i].flags.sweep)
+	}
+	ASSERT_ALWAYS(path.back().type_ == step_type::close)
+	ASSERT_ALWAYS(path[path.size() - 2].x == 29)
+
+	// replacing steps with the ones having more, less and same number of coordinates
+	{
+		auto p = path;
+		auto expected = steps;
+
+		auto replace = [&p, &expected](size_t i, const svgdom::path_element::step& s){
+			p.set(i, s);
+			expected[i] = s;
+			ASSERT_ALWAYS(p == svgdom::path_element::packed_path(expected))
+		};
+
+		svgdom::path_element::step s{};
+		s.type_ = step_type::cubic_rel;
+		s.x1 = 31;
+		s.y1 = 32;
+		s.x2 = 33;
+		s.y2 = 34;
+		s.x = 35;
+		s.y = 36;
+		replace(1, s);
+		ASSERT_ALWAYS(p.coordinates().size() == 35)
+
+		s = svgdom::path_element::step{};
+		s.type_ = step_type::close;
+		replace(3, s);
+		ASSERT_ALWAYS(p.coordinates().size() == 29)
+
+		s = svgdom::path_element::step{};
+		s.type_ = step_type::arc_rel;
+		s.rx = 37;
+		s.x = 38;
+		s.flags.sweep = true;
+		replace(8, s);
+		ASSERT_ALWAYS(p[8].flags.sweep && !p[8].flags.large_arc && p[8].x == 38)
+
+		s = svgdom::path_element::step{};
+		s.type_ = step_type::line_abs;
+		s.x = 39;
+		replace(9, s);
+		ASSERT_ALWAYS(p.back().x == 39)
+
+		// the original path is not changed
+		ASSERT_ALWAYS(path == svgdom::path_element::packed_path(steps))
+	}
+
+	// long numbers, digits are converted in groups of 8
+	{
+		auto p = svgdom::path_element::parse("M123456789.125,0.000012345678 L-98765432.1e-3 12345678 h 1234567.87654321 V 00000000000000000000001.5 z");
+		ASSERT_INFO_ALWAYS(p.size() == 5, "p.size() = " << p.size())
+
+		std::vector<svgdom::real> expected = {
+			svgdom::real(123456789.125),
+			svgdom::real(0.000012345678),
+			svgdom::real(-98765432.1e-3),
+			svgdom::real(12345678),
+			svgdom::real(1234567.87654321),
+			svgdom::real(1.5)
+		};
+		ASSERT_ALWAYS(p.coordinates().size() == expected.size())
+		for(size_t i = 0; i != expected.size(); ++i){
+			ASSERT_INFO_ALWAYS(p.coordinates()[i] == expected[i], "i = " << i << ", coordinate = " << p.coordinates()[i] << ", expected = " << expected[i])
+		}
+	}
+
+	// Numbers are compared to correctly rounded conversion via double. Each number is parsed at the end
+	// of the string, where digits are converted one by one, and followed by other coordinates, where runs
+	// of digits are converted 8 at a time. Runs of 7, 8, 9, 16 and 17 digits check the boundaries of 8-digit chunks.
+	{
+		std::vector<const char*> numbers = {
+			"0",
+			"7",
+			"-7",
+			"+7",
+			"1234567",
+			"12345678",
+			"123456789",
+			"1234567812345678",
+			"12345678123456789",
+			"-12345678.12345678",
+			"0.1234567",
+			"0.12345678",
+			"0.123456789",
+			".12345678",
+			"-.5",
+			"1.",
+			"00000000",
+			"000000001",
+			"0000000012345678",
+			"00000000.00000001",
+			"0.000000001",
+			"000.000000012345678",
+			"100000000",
+			"99999999.99999999",
+			"123456789012345678901234",
+			"0.123456789012345678901234",
+			"12345678901234567890.123456789",
+			"1e0",
+			"1e5",
+			"1E5",
+			"1e+5",
+			"1.5e-3",
+			"-2.5E-10",
+			"12345678e-8",
+			"123456789e10",
+			"0.00000000000000000001e20",
+			"1e38",
+			"1e-38",
+			"3.4028234e38",
+			"1.17549435e-38",
+			"0e100",
+			"0.0e-100"
+		};
+
+		for(auto n : numbers){
+			auto expected = svgdom::real(std::strtod(n, nullptr));
+
+			std::vector<std::pair<const char*, size_t>> suffixes = {
+				{"", 2},
+				{" 0 0 0 0 0 0 0 0 0", 10},
+				{",12345678,12345678 0", 4}
+			};
+
+			for(auto& suffix : suffixes){
+				auto str = std::string("M") + n + suffix.first;
+				auto p = svgdom::path_element::parse(str);
+				ASSERT_INFO_ALWAYS(p.coordinates().size() == suffix.second, "str = " << str << ", p.coordinates().size() = " << p.coordinates().size())
+				ASSERT_INFO_ALWAYS(p.coordinates()[0] == expected, "str = " << str << ", coordinate = " << p.coordinates()[0] << ", expected = " << expected)
+			}
+		}
+	}
+
+	// truncated and malformed path data
+	{
+		// if the string ends in the middle of a step, missing coordinates are zeros,
+		// if there is something else than a number, the step is discarded
+		std::vector<std::pair<const char*, const char*>> cases = {
+			{"M 1 2 L", "M1,2 L0,0"},
+			{"M 1 2 L 3", "M1,2 L3,0"},
+			{"M 1 2 L 3 ", "M1,2 L3,0"},
+			{"M 1 2 L 3,", "M1,2 L3,0"},
+			{"M 1 2 L 3 4 5", "M1,2 L3,4 5,0"},
+			{"M 1 2 Q 1", "M1,2 Q1,0 0,0"},
+			{"M 1 2 h", "M1,2 h0"},
+			{"M 1 2 A 1 2 3 1 0 5", "M1,2 A1,2 3 1,0 5,0"},
+			{"M 1 2 A 1 2 3 1", "M1,2"}, // arc flags have no defaults
+			{"M 1 2 L 3 x", "M1,2"},
+			{"M 1 2 L 3 4 x 5", "M1,2 L3,4"},
+			{"M 1 2 z 3", "M1,2 z"},
+			{"x", ""}
+		};
+
+		for(auto& c : cases){
+			svgdom::path_element e;
+			e.path = svgdom::path_element::parse(c.first);
+			ASSERT_INFO_ALWAYS(e.path_to_string() == c.second, "input = '" << c.first << "', output = '" << e.path_to_string() << "'")
+		}
+	}
+
+	// truncated and malformed polyline points
+	{
+		std::vector<std::pair<const char*, std::vector<svgdom::real>>> cases = {
+			{"1 2 3", {1, 2, 3, 0}},
+			{"1,2 3,", {1, 2, 3, 0}},
+			{"1 2 3 4 5", {1, 2, 3, 4, 5, 0}},
+			{"1,2 3,x", {1, 2}},
+			{"1 2 3 4 .", {1, 2, 3, 4}},
+			{"", {}}
+		};
+
+		for(auto& c : cases){
+			auto points = svgdom::polyline_shape::parse(c.first);
+			ASSERT_INFO_ALWAYS(points.size() * 2 == c.second.size(), "input = '" << c.first << "', points.size() = " << points.size())
+			for(size_t i = 0; i != points.size(); ++i){
+				ASSERT_INFO_ALWAYS(points[i][0] == c.second[i * 2] && points[i][1] == c.second[i * 2 + 1], "input = '" << c.first << "', i = " << i)
+			}
+		}
+	}
+
+	// close path takes one byte, line takes one byte plus two coordinates
+	{
+		svgdom::path_element::packed_path p;
+		svgdom::path_element::step s{};
+		s.type_ = step_type::line_abs;
+		p.push_back(s);
+		s.type_ = step_type::close;
+		p.push_back(s);
+		ASSERT_ALWAYS(p.commands().size() == 2)
+		ASSERT_ALWAYS(p.coordinates().size() == 2)
+	}
+}
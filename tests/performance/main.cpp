@@ -1,28 +1,507 @@
 #include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/batch.hpp"
+#include "../../src/svgdom/cloner.hpp"
+#include "../../src/svgdom/finder.hpp"
+#include "../../src/svgdom/id_index.hpp"
+#include "../../src/svgdom/node_table.hpp"
+#include "../../src/svgdom/snapshot.hpp"
+#include "../../src/svgdom/snapshot_view.hpp"
+#include "../../src/svgdom/style_stack.hpp"
+#include "../../src/svgdom/visitor.hpp"
+#include "../../src/svgdom/visit_tree.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <new>
+#include <cstdlib>
 
 #include <utki/debug.hpp>
 
 #include <papki/fs_file.hpp>
 
+// Benchmark suite.
+// Usage: tests [<output-json-file>]
+// Prints results table to stdout and writes machine-readable results to the JSON file,
+// "benchmark.json" by default.
+
 namespace{
-uint32_t getTicks(){
-	return uint32_t(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+// global allocation counters, see operator new() replacements below
+std::atomic<size_t> num_allocations{0};
+std::atomic<size_t> num_allocated_bytes{0};
 }
+
+void* operator new(size_t size){
+	++num_allocations;
+	num_allocated_bytes += size;
+	if(auto p = std::malloc(size == 0 ? 1 : size)){
+		return p;
+	}
+	throw std::bad_alloc();
 }
 
-int main(int argc, char** argv){
-	auto loadStart = getTicks();
-	
-	auto buf = papki::fs_file("../samples/testdata/back.svg").load();
-	
-	TRACE_ALWAYS(<< "SVG loaded in " << float(getTicks() - loadStart) / 1000.0f << " sec." << std::endl)
-	
-	for(unsigned i = 0; i != 5; ++i){
-		auto parseStart = getTicks();
-		auto dom = svgdom::load(utki::make_span(buf));
+void operator delete(void* p)noexcept{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t)noexcept{
+	std::free(p);
+}
+
+namespace{
+struct document{
+	std::string name;
+	std::string path; // empty for synthetic documents
+	std::vector<char> data;
+	size_t num_elements = 0;
+};
+
+struct result{
+	std::string benchmark;
+	std::string document;
+	size_t bytes;
+	size_t elements;
+	size_t iterations;
+	double ns_per_op;
+	double allocations_per_element;
+	double bytes_per_element;
+
+	double mb_per_sec()const{
+		return double(this->bytes) / (1024 * 1024) / (this->ns_per_op / 1e9);
+	}
+};
+
+std::vector<result> results;
+
+class element_counter : public svgdom::const_visitor{
+public:
+	size_t count = 0;
+
+	void default_visit(const svgdom::element& e)override{
+		++this->count;
+	}
+
+	void default_visit(const svgdom::element& e, const svgdom::container& c)override{
+		++this->count;
+		this->relay_accept(c);
+	}
+};
+
+size_t count_elements(const svgdom::element& e){
+	element_counter c;
+	e.accept(c);
+	return c.count;
+}
+
+// counts path elements and their coordinates
+class path_counter : public svgdom::const_visitor{
+public:
+	size_t count = 0;
+
+	void visit(const svgdom::path_element& e)override{
+		this->count += 1 + e.path.coordinates().size();
+	}
+};
+
+// Resolves a set of style properties for every styleable element, like a renderer does.
+class style_resolver : public svgdom::const_visitor{
+	svgdom::style_stack ss;
+
+	void resolve(const svgdom::styleable& s){
+		for(auto p : {
+				svgdom::style_property::fill,
+				svgdom::style_property::fill_opacity,
+				svgdom::style_property::fill_rule,
+				svgdom::style_property::stroke,
+				svgdom::style_property::stroke_width,
+				svgdom::style_property::stroke_opacity,
+				svgdom::style_property::stroke_linecap,
+				svgdom::style_property::stroke_linejoin,
+				svgdom::style_property::opacity,
+				svgdom::style_property::display,
+				svgdom::style_property::visibility,
+				svgdom::style_property::stop_color
+			})
+		{
+			if(this->ss.get_style_property(p)){
+				++this->num_resolved;
+			}
+		}
+	}
+public:
+	size_t num_resolved = 0;
+
+	void visit(const svgdom::style_element& e)override{
+		this->ss.add_css(e);
+	}
+
+	void default_visit(const svgdom::element& e)override{
+		if(auto s = dynamic_cast<const svgdom::styleable*>(&e)){
+			svgdom::style_stack::push push(this->ss, *s);
+			this->resolve(*s);
+		}
+	}
+
+	void default_visit(const svgdom::element& e, const svgdom::container& c)override{
+		if(auto s = dynamic_cast<const svgdom::styleable*>(&e)){
+			svgdom::style_stack::push push(this->ss, *s);
+			this->resolve(*s);
+			this->relay_accept(c);
+		}else{
+			this->relay_accept(c);
+		}
+	}
+};
+
+// Runs the operation repeatedly for at least the minimal time and records the fastest run.
+template <typename T_operation>
+void run(const std::string& benchmark, const std::string& doc_name, size_t bytes, size_t elements, const T_operation& op){
+	using namespace std::chrono;
+
+	const auto min_duration = milliseconds(200);
+	const size_t min_iterations = 3;
+
+	// warm up and measure allocations
+	auto allocs_before = num_allocations.load();
+	auto bytes_before = num_allocated_bytes.load();
+	op();
+	auto allocs = num_allocations.load() - allocs_before;
+	auto allocated_bytes = num_allocated_bytes.load() - bytes_before;
+
+	size_t iterations = 0;
+	nanoseconds best = nanoseconds::max();
+	auto start = steady_clock::now();
+	while(iterations < min_iterations || steady_clock::now() - start < min_duration){
+		auto t = steady_clock::now();
+		op();
+		best = std::min(best, duration_cast<nanoseconds>(steady_clock::now() - t));
+		++iterations;
+	}
+
+	result r;
+	r.benchmark = benchmark;
+	r.document = doc_name;
+	r.bytes = bytes;
+	r.elements = elements;
+	r.iterations = iterations;
+	r.ns_per_op = double(std::max(best.count(), decltype(best.count())(1)));
+	r.allocations_per_element = elements == 0 ? 0 : double(allocs) / double(elements);
+	r.bytes_per_element = elements == 0 ? 0 : double(allocated_bytes) / double(elements);
+
+	std::cout << std::left << std::setw(14) << r.benchmark
+			<< std::setw(36) << r.document
+			<< std::right << std::setw(14) << std::fixed << std::setprecision(0) << r.ns_per_op << " ns"
+			<< std::setw(10) << std::setprecision(2) << r.mb_per_sec() << " MB/s"
+			<< std::setw(10) << std::setprecision(2) << r.allocations_per_element << " allocs/elem"
+			<< std::setw(10) << std::setprecision(1) << r.bytes_per_element << " bytes/elem"
+			<< std::endl;
+
+	results.push_back(std::move(r));
+}
+
+void benchmark_document(const document& d){
+	auto buf = utki::make_span(d.data);
+
+	run("load", d.name, d.data.size(), d.num_elements, [&buf](){
+		auto dom = svgdom::load(buf);
 		ASSERT_ALWAYS(dom)
-		TRACE_ALWAYS(<< "SVG parsed in " << float(getTicks() - parseStart) / 1000.0f << " sec." << std::endl)
+	});
+
+	{
+		std::istringstream s(std::string(d.data.begin(), d.data.end()));
+		run("load_istream", d.name, d.data.size(), d.num_elements, [&s](){
+			s.clear();
+			s.seekg(0);
+			auto dom = svgdom::load(s);
+			ASSERT_ALWAYS(dom)
+		});
+	}
+
+	run("load_lazy", d.name, d.data.size(), d.num_elements, [&buf](){
+		auto dom = svgdom::load_lazy(buf);
+		ASSERT_ALWAYS(dom)
+	});
+
+	if(!d.path.empty()){
+		run("load_mapped", d.name, d.data.size(), d.num_elements, [&d](){
+			auto dom = svgdom::load_mapped(d.path);
+			ASSERT_ALWAYS(dom)
+		});
+	}
+
+	auto dom = svgdom::load(buf);
+	ASSERT_ALWAYS(dom)
+
+	run("to_string", d.name, d.data.size(), d.num_elements, [&dom](){
+		auto str = dom->to_string();
+		ASSERT_ALWAYS(!str.empty())
+	});
+
+	run("save_snapshot", d.name, d.data.size(), d.num_elements, [&dom](){
+		auto snapshot = svgdom::save_snapshot(*dom);
+		ASSERT_ALWAYS(!snapshot.empty())
+	});
+
+	{
+		auto snapshot = svgdom::save_snapshot(*dom);
+		run("load_snapshot", d.name, d.data.size(), d.num_elements, [&snapshot](){
+			auto dom = svgdom::load_snapshot(utki::make_span(snapshot));
+			ASSERT_ALWAYS(dom)
+		});
+
+		run("snapshot_view", d.name, d.data.size(), d.num_elements, [&snapshot](){
+			svgdom::snapshot_view view(utki::make_span(snapshot));
+			element_counter c;
+			view.root().accept(c);
+			ASSERT_ALWAYS(c.count != 0)
+		});
+	}
+
+	run("clone", d.name, d.data.size(), d.num_elements, [&dom](){
+		svgdom::cloner c;
+		dom->accept(c);
+		auto clone = c.get_clone_as<svgdom::svg_element>();
+		ASSERT_ALWAYS(clone)
+	});
+
+	run("clone_cow", d.name, d.data.size(), d.num_elements, [&dom](){
+		svgdom::cloner c(true);
+		dom->accept(c);
+		auto clone = c.get_clone_as<svgdom::svg_element>();
+		ASSERT_ALWAYS(clone)
+	});
+
+	run("finder", d.name, d.data.size(), d.num_elements, [&dom](){
+		svgdom::finder f(*dom);
+	});
+
+	run("visit_virtual", d.name, d.data.size(), d.num_elements, [&dom](){
+		path_counter c;
+		dom->accept(c);
+		ASSERT_ALWAYS(c.count != size_t(-1))
+	});
+
+	run("visit_tree", d.name, d.data.size(), d.num_elements, [&dom](){
+		size_t count = 0;
+		const svgdom::element& root = *dom;
+		svgdom::visit_tree(root, svgdom::overloaded{
+				[&count](const svgdom::path_element& e){
+					count += 1 + e.path.coordinates().size();
+				},
+				[](const svgdom::element& e){}
+			});
+		ASSERT_ALWAYS(count != size_t(-1))
+	});
+
+	run("node_table", d.name, d.data.size(), d.num_elements, [&dom](){
+		svgdom::node_table t(*dom);
+		ASSERT_ALWAYS(t.size() != 0)
+	});
+
+	{
+		svgdom::id_index index(*dom);
+		run("id_index_edit", d.name, d.data.size(), d.num_elements, [&dom, &index](){
+			// edits of a few elements do not depend on the document size
+			for(unsigned i = 0; i != 100; ++i){
+				auto r = std::make_unique<svgdom::rect_element>();
+				r->id = "edited";
+				auto iter = index.insert(*dom, dom->children.end(), std::move(r));
+				index.set_id(**iter, "edited2");
+				ASSERT_ALWAYS(index.find_by_id("edited2"))
+				index.remove(*dom, iter);
+			}
+		});
+	}
+
+	run("style_stack", d.name, d.data.size(), d.num_elements, [&dom](){
+		style_resolver r;
+		dom->accept(r);
+	});
+}
+
+document make_document(std::string name, const std::string& svg){
+	document d;
+	d.name = std::move(name);
+	d.data.assign(svg.begin(), svg.end());
+	return d;
+}
+
+// many sibling paths with long path data
+document make_many_paths_document(){
+	std::stringstream ss;
+	ss << R"(<svg xmlns="http://www.w3.org/2000/svg" width="1000" height="1000">)" << '\n';
+	for(unsigned i = 0; i != 10000; ++i){
+		ss << R"(<path id="p)" << i << R"(" fill="#)" << std::hex << std::setw(6) << std::setfill('0') << (i * 2654435761u) % 0x1000000 << std::dec
+				<< R"(" stroke="black" stroke-width="1.5" d="M )" << i % 1000 << ' ' << i / 10;
+		for(unsigned j = 0; j != 20; ++j){
+			ss << " L " << (i * 7 + j * 13) % 1000 << '.' << j << ' ' << (i * 3 + j * 17) % 1000 << ".25";
+		}
+		ss << " C 1.5 2.5 3.5 4.5 5.5 6.5 z\"/>\n";
+	}
+	ss << "</svg>\n";
+	return make_document("synthetic:many_paths", ss.str());
+}
+
+// deeply nested groups with transformations and inherited styles
+document make_deep_document(){
+	std::stringstream ss;
+	ss << R"(<svg xmlns="http://www.w3.org/2000/svg" width="1000" height="1000" fill="red">)" << '\n';
+	const unsigned depth = 300;
+	for(unsigned i = 0; i != depth; ++i){
+		ss << R"(<g id="g)" << i << "\" transform=\"translate(1, 1) rotate(" << i % 360 << ")\"";
+		if(i % 10 == 0){
+			ss << R"( stroke="blue" style="stroke-width: )" << i % 7 + 1 << R"(; opacity: 0.9")";
+		}
+		ss << ">\n";
+		ss << R"(<rect x="0" y="0" width="10" height="10"/>)" << '\n';
+	}
+	for(unsigned i = 0; i != depth; ++i){
+		ss << "</g>\n";
+	}
+	ss << "</svg>\n";
+	return make_document("synthetic:deep", ss.str());
+}
+
+// big stylesheet with many class rules and elements using them
+document make_css_document(){
+	std::stringstream ss;
+	ss << R"(<svg xmlns="http://www.w3.org/2000/svg" width="1000" height="1000">)" << '\n';
+	ss << "<style>\n";
+	for(unsigned i = 0; i != 500; ++i){
+		ss << ".c" << i << " { fill: #" << std::hex << std::setw(6) << std::setfill('0') << (i * 2654435761u) % 0x1000000 << std::dec
+				<< "; stroke-width: " << i % 5 + 1 << "; }\n";
+	}
+	ss << "g rect { stroke: black; }\n";
+	ss << "#r7 { fill: blue; }\n";
+	ss << "</style>\n";
+	for(unsigned i = 0; i != 100; ++i){
+		ss << R"(<g class="c)" << i << R"(">)" << '\n';
+		for(unsigned j = 0; j != 50; ++j){
+			ss << R"(<rect id="r)" << i * 50 + j << R"(" class="c)" << (i * 50 + j) % 500 << R"(" x="1" y="2" width="3" height="4"/>)" << '\n';
+		}
+		ss << "</g>\n";
+	}
+	ss << "</svg>\n";
+	return make_document("synthetic:css", ss.str());
+}
+
+void benchmark_batch(const std::vector<document>& docs){
+	// repeat the corpus to get a batch big enough for measuring
+	const unsigned num_repeats = 10;
+
+	std::vector<utki::span<const char>> batch;
+	size_t batch_bytes = 0;
+	size_t batch_elements = 0;
+	for(unsigned i = 0; i != num_repeats; ++i){
+		for(auto& d : docs){
+			batch.push_back(utki::make_span(d.data));
+			batch_bytes += d.data.size();
+			batch_elements += d.num_elements;
+		}
+	}
+
+	run("batch_seq", "corpus x " + std::to_string(num_repeats), batch_bytes, batch_elements, [&batch](){
+		for(auto& b : batch){
+			auto dom = svgdom::load(b);
+			ASSERT_ALWAYS(dom)
+		}
+	});
+
+	for(unsigned num_threads : {1, 2, 4, 0}){
+		std::string name = "batch_" + (num_threads == 0 ? std::string("auto") : std::to_string(num_threads));
+		run(name, "corpus x " + std::to_string(num_repeats), batch_bytes, batch_elements, [&batch, num_threads](){
+			auto res = svgdom::load_batch(utki::make_span(batch), num_threads);
+			ASSERT_ALWAYS(res.documents.size() == batch.size())
+			for(size_t i = 0; i != res.documents.size(); ++i){
+				ASSERT_INFO_ALWAYS(res.documents[i], "document #" << i << " failed to load")
+			}
+		});
+	}
+}
+
+std::string escape_json(const std::string& str){
+	std::string ret;
+	for(auto c : str){
+		if(c == '"' || c == '\\'){
+			ret += '\\';
+		}
+		ret += c;
+	}
+	return ret;
+}
+
+void write_json(const std::string& file_name){
+	std::ofstream f(file_name);
+	f << "[\n";
+	for(size_t i = 0; i != results.size(); ++i){
+		const auto& r = results[i];
+		f << "\t{"
+				<< "\"benchmark\": \"" << escape_json(r.benchmark) << "\", "
+				<< "\"document\": \"" << escape_json(r.document) << "\", "
+				<< "\"bytes\": " << r.bytes << ", "
+				<< "\"elements\": " << r.elements << ", "
+				<< "\"iterations\": " << r.iterations << ", "
+				<< std::fixed << std::setprecision(0)
+				<< "\"ns_per_op\": " << r.ns_per_op << ", "
+				<< std::setprecision(3)
+				<< "\"mb_per_sec\": " << r.mb_per_sec() << ", "
+				<< "\"allocations_per_element\": " << r.allocations_per_element << ", "
+				<< "\"bytes_per_element\": " << r.bytes_per_element
+				<< "}" << (i + 1 == results.size() ? "" : ",") << "\n";
+	}
+	f << "]\n";
+}
+}
+
+int main(int argc, char** argv){
+	std::string out_file_name = argc >= 2 ? argv[1] : "benchmark.json";
+
+	std::vector<document> corpus;
+	{
+		const std::string dir = "../samples/testdata/";
+		auto files = papki::fs_file(dir).list_dir();
+		std::sort(files.begin(), files.end());
+		for(auto& f : files){
+			if(f.size() < 4 || f.substr(f.size() - 4) != ".svg"){
+				continue;
+			}
+			auto data = papki::fs_file(dir + f).load();
+			document d;
+			d.name = f;
+			d.path = dir + f;
+			d.data.assign(data.begin(), data.end());
+			corpus.push_back(std::move(d));
+		}
+	}
+	ASSERT_ALWAYS(!corpus.empty())
+
+	std::vector<document> synthetic = {
+		make_many_paths_document(),
+		make_deep_document(),
+		make_css_document()
+	};
+
+	for(auto* docs : {&corpus, &synthetic}){
+		for(auto& d : *docs){
+			auto dom = svgdom::load(utki::make_span(d.data));
+			ASSERT_INFO_ALWAYS(dom, "failed to load " << d.name)
+			d.num_elements = count_elements(*dom);
+		}
 	}
+
+	for(auto& d : corpus){
+		benchmark_document(d);
+	}
+	for(auto& d : synthetic){
+		benchmark_document(d);
+	}
+
+	benchmark_batch(corpus);
+
+	write_json(out_file_name);
+
+	std::cout << "results written to " << out_file_name << std::endl;
 }
@@ -1,4 +1,5 @@
 #include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/snapshot.hpp"
 
 #include <utki/debug.hpp>
 
@@ -26,6 +27,15 @@ int main(int argc, char** argv){
 	ASSERT_ALWAYS(dom)
 	
 	auto str = dom->to_string();
+
+	auto mapped_dom = svgdom::load_mapped(filename);
+	ASSERT_ALWAYS(mapped_dom)
+	ASSERT_ALWAYS(mapped_dom->to_string() == str)
+
+	auto snapshot = svgdom::save_snapshot(*dom);
+	auto snapshot_dom = svgdom::load_snapshot(utki::make_span(snapshot));
+	ASSERT_ALWAYS(snapshot_dom)
+	ASSERT_ALWAYS(snapshot_dom->to_string() == str)
 //	TRACE_ALWAYS(<< str << std::endl)
 	
 	papki::fs_file outFile("out.svg");
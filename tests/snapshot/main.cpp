@@ -0,0 +1,319 @@
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/snapshot.hpp"
+#include "../../src/svgdom/snapshot_view.hpp"
+#include "../../src/svgdom/stream_writer.hpp"
+#include "../../src/svgdom/cloner.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+
+#include <utki/debug.hpp>
+
+namespace{
+const std::string svg_str = R"qwertyuiop(
+<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink" id="root" width="200" height="100mm" viewBox="0 0 200 100" preserveAspectRatio="xMidYMid slice">
+	<style>
+		.red { fill: red; stroke-width: 2 !important }
+		#c1 > rect, path { stroke: url(#lg) }
+	</style>
+	<defs id="d">
+		<linearGradient id="lg" x1="1" y1="2%" x2="3" y2="4" spreadMethod="reflect" gradientUnits="userSpaceOnUse" gradientTransform="rotate(30)">
+			<stop offset="0" stop-color="#ff0000"/>
+			<stop offset="1" style="stop-color: blue; stop-opacity: 0.5"/>
+		</linearGradient>
+		<radialGradient id="rg" cx="10" cy="20" r="30" fx="40" fy="50" xlink:href="#lg"/>
+		<filter id="f" x="-10%" y="-10%" width="120%" height="120%" filterUnits="userSpaceOnUse" primitiveUnits="objectBoundingBox">
+			<feGaussianBlur in="SourceGraphic" stdDeviation="2 3" result="blur"/>
+			<feColorMatrix in="blur" type="saturate" values="0.5"/>
+			<feBlend in="SourceGraphic" in2="blur" mode="multiply"/>
+			<feComposite in="SourceGraphic" in2="blur" operator="arithmetic" k1="1" k2="2" k3="3" k4="4"/>
+		</filter>
+		<mask id="m" x="1" y="2" width="3" height="4" maskUnits="userSpaceOnUse" maskContentUnits="objectBoundingBox">
+			<rect width="10" height="10" fill="white"/>
+		</mask>
+		<symbol id="s" viewBox="0 0 10 10" preserveAspectRatio="none">
+			<circle id="c1" cx="5" cy="5" r="4" class="red big"/>
+		</symbol>
+	</defs>
+	<g id="g" transform="translate(10, 20) scale(2) matrix(1 2 3 4 5 6) skewX(5) skewY(6)" style="fill: #00ff00; stroke-dasharray: 1 2 3; display: none; visibility: hidden" opacity="0.3">
+		<path id="p" d="M 0 0 L 10 10 C 1 2 3 4 5 6 A 1 2 3 1 0 7 8 Q 1 2 3 4 T 5 6 S 1 2 3 4 H 1 V 2 z m 1 1 l 1 1 h 1 v 1 z" fill-rule="evenodd" stroke-linecap="round" stroke-linejoin="bevel" enable-background="new 1 2 3 4"/>
+		<rect x="1" y="2" width="3" height="4" rx="5" ry="6" filter="url(#f)"/>
+		<ellipse cx="1" cy="2" rx="3" ry="4" color-interpolation-filters="linearRGB"/>
+		<line x1="1" y1="2" x2="3" y2="4" stroke="currentColor"/>
+		<polyline points="1 2 3 4 5 6" fill="none"/>
+		<polygon points="1 2 3 4 5 6 7 8" fill="inherit"/>
+	</g>
+	<use xlink:href="#s" x="10" y="20" width="30" height="40" transform="rotate(45 1 2)"/>
+	<image xlink:href="image.png" x="1" y="2" width="3" height="4" preserveAspectRatio="xMaxYMin meet"/>
+	<text id="t" transform="scale(3)" mask="url(#m)"/>
+</svg>
+)qwertyuiop";
+}
+
+int main(int argc, char** argv){
+	auto dom = svgdom::load(svg_str);
+	ASSERT_ALWAYS(dom)
+
+	auto str = dom->to_string();
+
+	auto key = svgdom::make_snapshot_source_key(utki::make_span(svg_str));
+
+	auto snapshot = svgdom::save_snapshot(*dom, key);
+
+	// round trip gives same document
+	{
+		auto loaded = svgdom::load_snapshot(utki::make_span(snapshot), key);
+		ASSERT_ALWAYS(loaded)
+		ASSERT_INFO_ALWAYS(loaded->to_string() == str, "loaded = " << loaded->to_string() << std::endl << "expected = " << str)
+
+		// snapshot of loaded document is same as original snapshot
+		ASSERT_ALWAYS(svgdom::save_snapshot(*loaded, key) == snapshot)
+	}
+
+	// snapshot of lazily loaded document is same as of eagerly loaded one
+	{
+		auto lazy_dom = svgdom::load_lazy(utki::make_span(svg_str));
+		ASSERT_ALWAYS(lazy_dom)
+		ASSERT_ALWAYS(svgdom::save_snapshot(*lazy_dom, key) == snapshot)
+	}
+
+	// view of snapshot traversed with visitor gives same document
+	{
+		svgdom::snapshot_view view(utki::make_span(snapshot), key);
+
+		std::stringstream ss;
+		svgdom::stream_writer w(ss);
+		view.root().accept(w);
+		ASSERT_INFO_ALWAYS(ss.str() == str, "view = " << ss.str() << std::endl << "expected = " << str)
+	}
+
+	// visitors which accept children of the container one by one also work with view
+	{
+		svgdom::snapshot_view view(utki::make_span(snapshot), key);
+
+		svgdom::cloner c;
+		view.root().accept(c);
+		auto clone = c.get_clone_as<svgdom::svg_element>();
+		ASSERT_ALWAYS(clone)
+
+		// cloner skips some element types, so compare to the clone of the original document
+		svgdom::cloner dom_cloner;
+		dom->accept(dom_cloner);
+		auto expected = dom_cloner.get_clone_as<svgdom::svg_element>()->to_string();
+		ASSERT_INFO_ALWAYS(clone->to_string() == expected, "clone = " << clone->to_string() << std::endl << "expected = " << expected)
+	}
+
+	// containers decoded from view hold their actual children
+	{
+		svgdom::snapshot_view view(utki::make_span(snapshot), key);
+
+		struct test_visitor : public svgdom::const_visitor{
+			std::vector<size_t> num_children;
+			size_t num_grandchildren = 0;
+
+			void default_visit(const svgdom::element& e, const svgdom::container& c)override{
+				this->num_children.push_back(c.children.size());
+				for(auto& child : c.children){
+					// children of the child are decoded when it accepts non-constant visitor as well
+					struct counter : public svgdom::visitor{
+						size_t n = 0;
+						void default_visit(svgdom::element& e, svgdom::container& c)override{
+							this->n += c.children.size();
+						}
+					} v;
+					child->accept(v);
+					this->num_grandchildren += v.n;
+				}
+				this->relay_accept(c);
+			}
+		};
+
+		test_visitor v;
+		view.root().accept(v);
+
+		test_visitor expected;
+		dom->accept(expected);
+
+		ASSERT_ALWAYS(!v.num_children.empty())
+		ASSERT_ALWAYS(v.num_children.front() == dom->children.size())
+		ASSERT_ALWAYS(v.num_children == expected.num_children)
+		ASSERT_ALWAYS(v.num_grandchildren == expected.num_grandchildren)
+		ASSERT_ALWAYS(v.num_grandchildren != 0)
+	}
+
+	// view accessors
+	{
+		svgdom::snapshot_view view(utki::make_span(snapshot), key);
+
+		auto root = view.root();
+		ASSERT_ALWAYS(root.type() == svgdom::element_type::svg)
+		ASSERT_ALWAYS(root.id() == "root")
+		ASSERT_ALWAYS(root.get_rectangle().height.value == 100)
+		ASSERT_ALWAYS(root.get_rectangle().height.unit == svgdom::length_unit::mm)
+		ASSERT_ALWAYS(root.get_view_box()[2] == 200)
+
+		auto children = root.children();
+		ASSERT_ALWAYS(std::distance(children.begin(), children.end()) == 6)
+
+		auto g = *std::next(children.begin(), 2);
+		ASSERT_ALWAYS(g.type() == svgdom::element_type::g)
+		ASSERT_ALWAYS(g.get_transformations().size() == 5)
+		auto g_element = dynamic_cast<const svgdom::g_element*>(std::next(dom->children.begin(), 2)->get());
+		ASSERT_ALWAYS(g_element)
+		ASSERT_ALWAYS(std::get<uint32_t>(g.get_style_property(svgdom::style_property::fill)) == std::get<uint32_t>(*g_element->get_style_property(svgdom::style_property::fill)))
+		ASSERT_ALWAYS(!svgdom::is_valid(g.get_style_property(svgdom::style_property::opacity)))
+		ASSERT_ALWAYS(std::get<svgdom::real>(g.get_presentation_attribute(svgdom::style_property::opacity)) == svgdom::real(0.3))
+
+		auto p = *g.children().begin();
+		ASSERT_ALWAYS(p.type() == svgdom::element_type::path)
+		ASSERT_ALWAYS(p.children().empty())
+		auto path = dynamic_cast<const svgdom::path_element*>(g_element->children.front().get());
+		ASSERT_ALWAYS(path)
+		auto coords = p.get_path_coordinates();
+		ASSERT_ALWAYS(std::equal(coords.begin(), coords.end(), path->path.coordinates().begin(), path->path.coordinates().end()))
+		ASSERT_ALWAYS(p.get_path_commands().size() == path->path.commands().size())
+
+		auto rect = *std::next(g.children().begin());
+		ASSERT_ALWAYS(rect.get_length(svgdom::element_view::length_attribute::ry).value == 6)
+		ASSERT_ALWAYS(rect.get_length(svgdom::element_view::length_attribute::cx).unit == svgdom::length_unit::unknown)
+
+		auto polygon = *std::next(g.children().begin(), 5);
+		ASSERT_ALWAYS(polygon.get_points().size() == 8)
+
+		auto use = *std::next(children.begin(), 3);
+		ASSERT_ALWAYS(use.get_iri() == "#s")
+	}
+
+	// view of memory mapped snapshot file
+	{
+		const std::string file_name = "out.snapshot";
+		{
+			std::ofstream f(file_name, std::ios::binary);
+			f.write(reinterpret_cast<const char*>(snapshot.data()), snapshot.size());
+		}
+
+		{
+			svgdom::snapshot_view view(file_name, key);
+			std::stringstream ss;
+			svgdom::stream_writer w(ss);
+			view.root().accept(w);
+			ASSERT_ALWAYS(ss.str() == str)
+		}
+
+		std::remove(file_name.c_str());
+	}
+
+	// unaligned snapshot data
+	{
+		std::vector<uint8_t> buf(snapshot.size() + 1);
+		std::copy(snapshot.begin(), snapshot.end(), std::next(buf.begin()));
+		auto loaded = svgdom::load_snapshot(utki::make_span(buf.data() + 1, snapshot.size()), key);
+		ASSERT_ALWAYS(loaded)
+		ASSERT_ALWAYS(loaded->to_string() == str)
+	}
+
+	// stale snapshot is rejected
+	{
+		bool thrown = false;
+		try{
+			svgdom::load_snapshot(utki::make_span(snapshot), key + 1);
+		}catch(svgdom::snapshot_error&){
+			thrown = true;
+		}
+		ASSERT_ALWAYS(thrown)
+	}
+
+	// snapshot of different version is rejected
+	{
+		auto s = snapshot;
+		++s[8]; // version follows the 8 byte magic
+		bool thrown = false;
+		try{
+			svgdom::load_snapshot(utki::make_span(s), key);
+		}catch(svgdom::snapshot_error&){
+			thrown = true;
+		}
+		ASSERT_ALWAYS(thrown)
+	}
+
+	// not a snapshot
+	{
+		bool thrown = false;
+		try{
+			svgdom::load_snapshot(utki::make_span(reinterpret_cast<const uint8_t*>(svg_str.data()), svg_str.size()));
+		}catch(svgdom::snapshot_error&){
+			thrown = true;
+		}
+		ASSERT_ALWAYS(thrown)
+	}
+
+	// truncated snapshot is rejected
+	for(size_t size = 0; size < snapshot.size(); size += 7){
+		bool thrown = false;
+		try{
+			svgdom::load_snapshot(utki::make_span(snapshot.data(), size), key);
+		}catch(svgdom::snapshot_error&){
+			thrown = true;
+		}
+		ASSERT_ALWAYS(thrown)
+	}
+
+	// invalid path command is rejected
+	{
+		// commands of the path start with move, line and cubic steps
+		std::vector<uint8_t> commands = {
+			uint8_t(svgdom::path_element::step::type::move_abs),
+			uint8_t(svgdom::path_element::step::type::line_abs),
+			uint8_t(svgdom::path_element::step::type::cubic_abs)
+		};
+		auto i = std::search(snapshot.begin(), snapshot.end(), commands.begin(), commands.end());
+		ASSERT_ALWAYS(i != snapshot.end())
+		auto offset = size_t(std::distance(snapshot.begin(), i));
+
+		for(uint8_t c : {uint8_t(0), uint8_t(svgdom::path_element::packed_path::type_mask), uint8_t(0x82), uint8_t(0x24)}){
+			auto s = snapshot;
+			s[offset + 1] = c;
+
+			bool thrown = false;
+			try{
+				svgdom::load_snapshot(utki::make_span(s), key);
+			}catch(svgdom::snapshot_error&){
+				thrown = true;
+			}
+			ASSERT_INFO_ALWAYS(thrown, "c = " << unsigned(c))
+
+			thrown = false;
+			try{
+				svgdom::snapshot_view view(utki::make_span(s), key);
+				std::stringstream ss;
+				svgdom::stream_writer w(ss);
+				view.root().accept(w);
+			}catch(svgdom::snapshot_error&){
+				thrown = true;
+			}
+			ASSERT_INFO_ALWAYS(thrown, "c = " << unsigned(c))
+		}
+	}
+
+	// corrupted snapshot either loads or is rejected, but does not crash
+	for(size_t i = 32; i < snapshot.size(); ++i){
+		auto s = snapshot;
+		s[i] ^= 0xff;
+		try{
+			auto loaded = svgdom::load_snapshot(utki::make_span(s), key);
+			ASSERT_ALWAYS(loaded)
+			loaded->to_string();
+		}catch(svgdom::snapshot_error&){}
+		try{
+			svgdom::snapshot_view view(utki::make_span(s), key);
+			std::stringstream ss;
+			svgdom::stream_writer w(ss);
+			view.root().accept(w);
+		}catch(svgdom::snapshot_error&){}
+	}
+
+	std::cout << "snapshot size = " << snapshot.size() << ", svg size = " << svg_str.size() << std::endl;
+}
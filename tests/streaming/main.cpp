@@ -0,0 +1,61 @@
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/visitor.hpp"
+
+#include <utki/debug.hpp>
+
+namespace{
+const std::string svg_str = R"qwertyuiop(
+<svg xmlns="http://www.w3.org/2000/svg" id="root">
+	<g id="g1">
+		<path id="p1" d="M 0 0 L 10 10"/>
+		<g id="g2">
+			<rect id="r1" width="10" height="20"/>
+		</g>
+		<unknown>
+			<rect id="r2"/>
+		</unknown>
+	</g>
+	<circle id="c1" r="5"/>
+</svg>
+)qwertyuiop";
+
+class path_visitor : public svgdom::visitor{
+public:
+	size_t num_steps = 0;
+
+	void visit(svgdom::path_element& e)override{
+		this->num_steps += e.path.size();
+	}
+};
+}
+
+int main(int argc, char** argv){
+	std::vector<std::string> ids;
+	path_visitor pv;
+
+	svgdom::load_streaming(
+			utki::make_span(svg_str),
+			[&ids, &pv](svgdom::element& e, utki::span<svgdom::element* const> ancestors){
+				std::string path;
+				for(auto a : ancestors){
+					ASSERT_ALWAYS(a)
+					path += a->id + "/";
+				}
+				ids.push_back(path + e.id);
+
+				e.accept(pv);
+			}
+		);
+
+	std::vector<std::string> expected = {
+		"root/g1/p1",
+		"root/g1/g2/r1",
+		"root/g1/g2",
+		"root/g1",
+		"root/c1",
+		"root"
+	};
+
+	ASSERT_INFO_ALWAYS(ids == expected, "ids.size() = " << ids.size())
+	ASSERT_ALWAYS(pv.num_steps == 2)
+}
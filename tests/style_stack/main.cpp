@@ -1,6 +1,8 @@
 #include "../../src/svgdom/dom.hpp"
 #include "../../src/svgdom/finder.hpp"
 
+#include <algorithm>
+
 #include <utki/debug.hpp>
 
 #include <papki/span_file.hpp>
@@ -40,8 +42,15 @@ class traverse_visitor : public svgdom::const_visitor{
 public:
 	svgdom::style_stack ss;
 
+	// use selector index built by the parser
+	bool use_element_index = false;
+
 	void visit(const svgdom::style_element& e)override{
-		this->ss.add_css(e.css);
+		if(this->use_element_index){
+			this->ss.add_css(e);
+		}else{
+			this->ss.add_css(e.css);
+		}
 	}
 
 	void visit(const svgdom::svg_element& e)override{
@@ -88,7 +97,91 @@ int main(int argc, char** argv){
 	ASSERT_ALWAYS(dom)
 	ASSERT_ALWAYS(dom->children.size() != 0)
 	
-	traverse_visitor v;
+	{
+		traverse_visitor v;
+		dom->accept(v);
+	}
+
+	// selector index of the style element
+	{
+		traverse_visitor v;
+		v.use_element_index = true;
+		dom->accept(v);
+	}
 
-	dom->accept(v);
+	// selector index is invalidated by changes to selectors
+	{
+		auto style = dynamic_cast<svgdom::style_element*>(dom->children.front().get());
+		ASSERT_ALWAYS(style)
+		ASSERT_ALWAYS(style->css.styles.size() == 2)
+		ASSERT_ALWAYS(style->selector_index.is_valid_for(style->css))
+
+		auto& selector = style->css.styles.front().selectors.back();
+		ASSERT_ALWAYS(selector.classes.size() == 1)
+
+		selector.classes.front() = "myBlue";
+		ASSERT_ALWAYS(!style->selector_index.is_valid_for(style->css))
+
+		// stale index is not used, so 'green1' circle gets no stroke from CSS
+		{
+			svgdom::style_stack ss;
+			ss.add_css(*style);
+			svgdom::style_stack::push push_svg(ss, *dom);
+			auto g = dynamic_cast<const svgdom::g_element*>(dom->children.back().get());
+			ASSERT_ALWAYS(g)
+			auto circle = dynamic_cast<const svgdom::circle_element*>(g->children.front().get());
+			ASSERT_ALWAYS(circle && circle->id == "green1")
+			svgdom::style_stack::push push_g(ss, *g);
+			svgdom::style_stack::push push_circle(ss, *circle);
+			ASSERT_ALWAYS(!ss.get_style_property(svgdom::style_property::stroke))
+		}
+
+		selector.classes.front() = "myGreen";
+		ASSERT_ALWAYS(style->selector_index.is_valid_for(style->css))
+
+		// changes to properties do not invalidate the index
+		style->css.styles.front().properties.clear();
+		ASSERT_ALWAYS(style->selector_index.is_valid_for(style->css))
+	}
+
+	// style map keeps properties sorted
+	{
+		svgdom::style_map m;
+		ASSERT_ALWAYS(m.empty())
+		ASSERT_ALWAYS(m.begin() == m.end())
+		ASSERT_ALWAYS(m.find(svgdom::style_property::fill) == m.end())
+		ASSERT_ALWAYS(m.erase(svgdom::style_property::fill) == 0)
+
+		std::vector<svgdom::style_property> props = {
+			svgdom::style_property::stroke_width,
+			svgdom::style_property::fill,
+			svgdom::style_property::stroke,
+			svgdom::style_property::opacity,
+			svgdom::style_property::display,
+			svgdom::style_property::fill_opacity
+		};
+		for(auto p : props){
+			m[p] = svgdom::real(unsigned(p));
+		}
+		ASSERT_ALWAYS(m.size() == props.size())
+		ASSERT_ALWAYS(std::is_sorted(m.begin(), m.end(), [](auto& a, auto& b){return a.first < b.first;}))
+		for(auto& v : m){
+			ASSERT_ALWAYS(std::get<svgdom::real>(v.second) == svgdom::real(unsigned(v.first)))
+		}
+
+		// copies are independent
+		auto c = m;
+		ASSERT_ALWAYS(m.erase(svgdom::style_property::fill) == 1)
+		ASSERT_ALWAYS(m.erase(svgdom::style_property::display) == 1)
+		m[svgdom::style_property::stroke] = svgdom::real(1);
+		ASSERT_ALWAYS(m.size() == props.size() - 2)
+		ASSERT_ALWAYS(m.count(svgdom::style_property::fill) == 0)
+		ASSERT_ALWAYS(c.size() == props.size())
+		ASSERT_ALWAYS(c.count(svgdom::style_property::fill) == 1)
+		ASSERT_ALWAYS(std::get<svgdom::real>(c[svgdom::style_property::stroke]) == svgdom::real(unsigned(svgdom::style_property::stroke)))
+
+		m.clear();
+		ASSERT_ALWAYS(m.empty())
+		ASSERT_ALWAYS(c.size() == props.size())
+	}
 }
@@ -3,6 +3,9 @@
 
 #include <utki/debug.hpp>
 
+#include <vector>
+#include <string>
+
 int main(int argc, char** argv){
 	auto dom = std::make_unique<svgdom::svg_element>();
 
@@ -41,4 +44,42 @@ int main(int argc, char** argv){
 	ASSERT_ALWAYS(str.find("xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" version=\"1.1\"") != std::string::npos)
 	
 	ASSERT_ALWAYS(str.find("fill:#4213fe") != std::string::npos)
+
+	// numbers are written with 6 significant digits, same as standard streams do
+	{
+		const std::vector<std::pair<svgdom::real, const char*>> values = {
+			{svgdom::real(0), "0"},
+			{svgdom::real(0.1), "0.1"},
+			{svgdom::real(1) / svgdom::real(3), "0.333333"},
+			{svgdom::real(-57.53997), "-57.54"},
+			{svgdom::real(1e-7), "1e-07"},
+			{svgdom::real(100000), "100000"},
+			{svgdom::real(1000000), "1e+06"},
+			{svgdom::real(123456789), "1.23457e+08"},
+			{svgdom::real(1e30), "1e+30"}
+		};
+
+		svgdom::path_element path;
+		std::string expected = "L";
+		for(auto& v : values){
+			svgdom::path_element::step step{};
+			step.type_ = svgdom::path_element::step::type::line_abs;
+			step.x = v.first;
+			step.y = v.first;
+			path.path.push_back(step);
+
+			if(expected.size() != 1){
+				expected += ' ';
+			}
+			expected += v.second;
+			expected += ',';
+			expected += v.second;
+		}
+
+		ASSERT_INFO_ALWAYS(path.path_to_string() == expected, "path = " << path.path_to_string() << ", expected = " << expected)
+
+		svgdom::rect_element rect;
+		rect.width = svgdom::length(values[3].first, svgdom::length_unit::mm);
+		ASSERT_INFO_ALWAYS(rect.to_string().find("width=\"-57.54mm\"") != std::string::npos, "rect = " << rect.to_string())
+	}
 }
@@ -0,0 +1,143 @@
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/node_table.hpp"
+#include "../../src/svgdom/visit_tree.hpp"
+
+#include <vector>
+
+#include <utki/debug.hpp>
+
+namespace{
+struct custom_container :
+		public svgdom::element,
+		public svgdom::container
+{
+	void accept(svgdom::visitor& v)override{
+		v.default_visit(*this, *this);
+	}
+	void accept(svgdom::const_visitor& v)const override{
+		v.default_visit(*this, *this);
+	}
+};
+}
+
+int main(int argc, char** argv){
+	// type tags of element classes
+	{
+		typedef svgdom::element_type et;
+		ASSERT_ALWAYS(svgdom::path_element().get_type() == et::path)
+		ASSERT_ALWAYS(svgdom::rect_element().get_type() == et::rect)
+		ASSERT_ALWAYS(svgdom::circle_element().get_type() == et::circle)
+		ASSERT_ALWAYS(svgdom::ellipse_element().get_type() == et::ellipse)
+		ASSERT_ALWAYS(svgdom::line_element().get_type() == et::line)
+		ASSERT_ALWAYS(svgdom::polyline_element().get_type() == et::polyline)
+		ASSERT_ALWAYS(svgdom::polygon_element().get_type() == et::polygon)
+		ASSERT_ALWAYS(svgdom::g_element().get_type() == et::g)
+		ASSERT_ALWAYS(svgdom::svg_element().get_type() == et::svg)
+		ASSERT_ALWAYS(svgdom::symbol_element().get_type() == et::symbol)
+		ASSERT_ALWAYS(svgdom::use_element().get_type() == et::use)
+		ASSERT_ALWAYS(svgdom::defs_element().get_type() == et::defs)
+		ASSERT_ALWAYS(svgdom::gradient::stop_element().get_type() == et::stop)
+		ASSERT_ALWAYS(svgdom::linear_gradient_element().get_type() == et::linear_gradient)
+		ASSERT_ALWAYS(svgdom::radial_gradient_element().get_type() == et::radial_gradient)
+		ASSERT_ALWAYS(svgdom::filter_element().get_type() == et::filter)
+		ASSERT_ALWAYS(svgdom::fe_gaussian_blur_element().get_type() == et::fe_gaussian_blur)
+		ASSERT_ALWAYS(svgdom::fe_color_matrix_element().get_type() == et::fe_color_matrix)
+		ASSERT_ALWAYS(svgdom::fe_blend_element().get_type() == et::fe_blend)
+		ASSERT_ALWAYS(svgdom::fe_composite_element().get_type() == et::fe_composite)
+		ASSERT_ALWAYS(svgdom::image_element().get_type() == et::image)
+		ASSERT_ALWAYS(svgdom::mask_element().get_type() == et::mask)
+		ASSERT_ALWAYS(svgdom::text_element().get_type() == et::text)
+		ASSERT_ALWAYS(svgdom::style_element().get_type() == et::style)
+		ASSERT_ALWAYS(custom_container().get_type() == et::unknown)
+
+		// value initialization still zero-initializes attributes
+		ASSERT_ALWAYS(std::make_unique<svgdom::gradient::stop_element>()->offset == 0)
+
+		// copies keep the tag
+		svgdom::rect_element r;
+		auto c = std::make_unique<svgdom::rect_element>(r);
+		ASSERT_ALWAYS(c->get_type() == et::rect)
+	}
+
+	auto dom = svgdom::load(std::string(
+			R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg">
+				<g id="g1">
+					<rect id="r1"/>
+					<g id="g2"><circle id="c1"/><path id="p1" d="M 0 0 L 1 1"/><rect id="r2"/></g>
+				</g>
+				<defs><linearGradient id="lg"><stop/></linearGradient></defs>
+				<filter><feGaussianBlur stdDeviation="2"/></filter>
+				<mask id="m1"><ellipse/></mask>
+			</svg>)qwertyuiop"
+		));
+	ASSERT_ALWAYS(dom)
+
+	{
+		auto custom = std::make_unique<custom_container>();
+		custom->children.push_back(std::make_unique<svgdom::line_element>());
+		dom->children.push_back(std::move(custom));
+	}
+
+	// traversal order and element classes are same as with visitor
+	{
+		std::vector<std::pair<const svgdom::element*, svgdom::element_type>> visited;
+
+		const svgdom::element& root = *dom;
+		svgdom::visit_tree(root, svgdom::overloaded{
+				[&visited](const svgdom::rect_element& e){
+					visited.emplace_back(&e, svgdom::element_type::rect);
+				},
+				[&visited](const svgdom::g_element& e){
+					visited.emplace_back(&e, svgdom::element_type::g);
+				},
+				[&visited](const auto& e){
+					visited.emplace_back(&e, e.get_type());
+				}
+			});
+
+		svgdom::node_table t(*dom);
+		ASSERT_INFO_ALWAYS(visited.size() == t.size(), "visited.size() = " << visited.size() << ", t.size() = " << t.size())
+		for(size_t i = 0; i != t.size(); ++i){
+			ASSERT_INFO_ALWAYS(visited[i].first == t[uint32_t(i)].e, "i = " << i)
+			ASSERT_INFO_ALWAYS(visited[i].second == t[uint32_t(i)].type, "i = " << i)
+		}
+		ASSERT_ALWAYS(visited.back().second == svgdom::element_type::line)
+		ASSERT_ALWAYS(visited[visited.size() - 2].second == svgdom::element_type::unknown)
+	}
+
+	// non-const traversal, fallback handler for svgdom::element
+	{
+		unsigned num_other = 0;
+		svgdom::visit_tree(*dom, svgdom::overloaded{
+				[](svgdom::rect_element& e){
+					e.id += "_edited";
+				},
+				[&num_other](svgdom::element& e){
+					++num_other;
+				}
+			});
+		ASSERT_INFO_ALWAYS(num_other == 14, "num_other = " << num_other)
+
+		unsigned num_edited = 0;
+		svgdom::visit_tree(*dom, [&num_edited](auto& e){
+			if(e.id == "r1_edited" || e.id == "r2_edited"){
+				++num_edited;
+			}
+		});
+		ASSERT_ALWAYS(num_edited == 2)
+	}
+
+	// single element
+	{
+		bool called = false;
+		svgdom::visit_element(*dom, svgdom::overloaded{
+				[&called](svgdom::svg_element& e){
+					called = true;
+				},
+				[](svgdom::element& e){
+					ASSERT_ALWAYS(false)
+				}
+			});
+		ASSERT_ALWAYS(called)
+	}
+}